@@ -0,0 +1,611 @@
+/********************************************************************************
+ * File: main.cpp
+ * Description:
+ *   Host microbenchmark of tsl::gfx::Renderer. Runs fixed workloads against the
+ *   headless framebuffer backend and prints nanoseconds per pixel or per glyph,
+ *   so the drawing code can be compared between commits on a plain Linux box.
+ *   Display list round trip checks run first, the exit code is 1 if any fails.
+ *
+ *   Usage: TESLA_HEADLESS_FONT=<font.ttf> ./tesla-benchmark [filter]
+ *   Only benchmarks whose name contains the filter are run.
+ ********************************************************************************/
+
+#define STBTT_STATIC
+#define TESLA_INIT_IMPL
+#include <tesla.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace tsl::gfx {
+
+    /**
+     * @brief Drives the renderer outside of an overlay and times its primitives
+     */
+    class HeadlessHost {
+    public:
+        using Workload = std::function<void(Renderer*)>;
+
+        /**
+         * @brief Renders frames into the headless framebuffers
+         */
+        HeadlessHost() : m_renderer(Renderer::get()) {
+            this->m_renderer.init();
+        }
+
+        ~HeadlessHost() {
+            this->m_renderer.exit();
+        }
+
+        /**
+         * @brief Times a workload inside a fully damaged frame
+         * @note The workload runs Iterations times per sample, the median of all samples gets reported
+         *
+         * @param name Benchmark name
+         * @param unit What gets counted, e.g. "px" or "glyph"
+         * @param unitsPerRun Units a single workload run covers
+         * @param workload Draw calls to time
+         * @param setup Runs before every workload run without being timed
+         */
+        void run(const char* name, const char* unit, const u64 unitsPerRun, const Workload& workload, const Workload& setup = nullptr) {
+            if (!this->m_filter.empty() && std::string(name).find(this->m_filter) == std::string::npos)
+                return;
+
+            std::vector<double> samples;
+            for (u32 sample = 0; sample < Samples + WarmupSamples; ++sample) {
+                Renderer::invalidateAll();
+                this->m_renderer.startFrame();
+                this->m_renderer.fillScreen({ 0x0, 0x0, 0x0, 0x0 });   // Latches the full frame damage
+
+                u64 elapsedNs = 0;
+                for (u32 iteration = 0; iteration < Iterations; ++iteration) {
+                    if (setup)
+                        setup(&this->m_renderer);
+
+                    const u64 startNs = hlp::getTimeNs();
+                    workload(&this->m_renderer);
+                    elapsedNs += hlp::getTimeNs() - startNs;
+                }
+
+                this->m_renderer.endFrame();
+                if (sample >= WarmupSamples)
+                    samples.push_back(static_cast<double>(elapsedNs) / (static_cast<double>(unitsPerRun) * Iterations));
+            }
+
+            std::sort(samples.begin(), samples.end());
+            printf("%-32s %10.3f ns/%-6s (min %.3f, max %.3f)\n", name, samples[samples.size() / 2], unit, samples.front(), samples.back());
+        }
+
+        /**
+         * @brief Renders one untimed, fully damaged frame, e.g. to let elements pick up their items
+         *
+         * @param draw Draw calls
+         */
+        void frame(const Workload& draw) {
+            this->m_renderer.waitForRenderThread();
+            Renderer::invalidateAll();
+            this->m_renderer.startFrame();
+            this->m_renderer.fillScreen({ 0x0, 0x0, 0x0, 0x0 });
+            draw(&this->m_renderer);
+            this->m_renderer.endFrame();
+        }
+
+        /**
+         * @brief Checks that two ways of drawing a frame give the same pixels
+         *
+         * @param name Check name
+         * @param reference Draw calls giving the expected frame
+         * @param draw Draw calls to check
+         * @return false if any pixel differs
+         */
+        bool checkSamePixels(const char* name, const Workload& reference, const Workload& draw) {
+            if (!this->m_filter.empty() && std::string(name).find(this->m_filter) == std::string::npos)
+                return true;
+
+            const std::vector<u16> expected = this->captureFrame(reference);
+            const u64 mismatched = HeadlessHost::countMismatches(this->captureFrame(draw), expected);
+            if (mismatched != 0)
+                printf("%-32s failed: %llu px differ\n", name, static_cast<unsigned long long>(mismatched));
+            else
+                printf("%-32s ok\n", name);
+            return mismatched == 0;
+        }
+
+        /**
+         * @brief Checks that a serialized display list replays to the frame it got recorded from
+         * @note The frame is drawn directly once as reference, then recorded, serialized and the recorded list dropped
+         *       together with everything it retained. The replay only has the serialized copies to draw from
+         *
+         * @param name Check name
+         * @param draw Draw calls of the frame, has to start with a full background clear
+         * @return false if any pixel differs
+         */
+        bool checkRoundTrip(const char* name, const Workload& draw) {
+            if (!this->m_filter.empty() && std::string(name).find(this->m_filter) == std::string::npos)
+                return true;
+
+            const std::vector<u16> expected = this->captureFrame(draw);
+
+            std::vector<u8> serialized;
+            {
+                DisplayList recorded;
+                Renderer::invalidateAll();
+                this->m_renderer.beginRecording(recorded);
+                draw(&this->m_renderer);
+                this->m_renderer.endRecording();
+                recorded.serialize(serialized);
+            }
+
+            DisplayList replayed;
+            if (!replayed.deserialize(serialized)) {
+                printf("%-32s failed: serialized list does not parse\n", name);
+                return false;
+            }
+
+            this->m_renderer.beginFramebuffer();
+            this->m_renderer.executeDisplayList(replayed);
+            const u16* framebuffer = static_cast<const u16*>(this->m_renderer.getCurrentFramebuffer());
+            const u64 mismatched = HeadlessHost::countMismatches({ framebuffer, framebuffer + expected.size() }, expected);
+            this->m_renderer.endFrame();
+
+            if (mismatched != 0)
+                printf("%-32s failed: %llu px differ (%zu bytes)\n", name, static_cast<unsigned long long>(mismatched), serialized.size());
+            else
+                printf("%-32s ok (%zu bytes)\n", name, serialized.size());
+            return mismatched == 0;
+        }
+
+        /**
+         * @brief Records draw calls into a display list without rendering them
+         *
+         * @param list Display list, gets emptied
+         * @param draw Draw calls
+         */
+        void record(DisplayList& list, const Workload& draw) {
+            this->m_renderer.waitForRenderThread();
+            Renderer::invalidateAll();
+            this->m_renderer.beginRecording(list);
+            draw(&this->m_renderer);
+            this->m_renderer.endRecording();
+        }
+
+        /**
+         * @brief Replays a display list the way primitives drew before they got clipped up front, every pixel
+         *        goes through the clip test of \ref Renderer::setPixelBlendDst
+         * @note Covers what a list of items records: rects, rounded rects, circles, text and scissors. Has to
+         *       run inside a fully damaged frame, the pixels match \ref Renderer::executeDisplayList
+         *
+         * @param renderer Renderer
+         * @param list Display list
+         */
+        static void replayPerPixel(Renderer* renderer, const DisplayList& list) {
+            for (const DisplayList::Command& command : list.getCommands()) {
+                switch (command.type) {
+                    case DisplayList::CommandType::Rect:
+                        HeadlessHost::drawRoundedRectDistance(renderer, command.x, command.y, command.w, command.h, 0, command.color);
+                        break;
+                    case DisplayList::CommandType::RoundedRect:
+                        HeadlessHost::drawRoundedRectDistance(renderer, command.x, command.y, command.w, command.h, command.param, command.color);
+                        break;
+                    case DisplayList::CommandType::Circle:
+                        if (command.flags & 1)
+                            HeadlessHost::drawCircleDistance(renderer, command.x, command.y, command.param, command.color);
+                        else
+                            renderer->drawCircle(command.x, command.y, command.param, false, command.color);
+                        break;
+                    case DisplayList::CommandType::QuarterCircle:
+                        if (command.flags & 1)
+                            HeadlessHost::drawQuarterCircleDistance(renderer, command.x, command.y, command.param, command.color, command.flags >> 1);
+                        else
+                            renderer->drawQuarterCircle(command.x, command.y, command.param, false, command.color, command.flags >> 1);
+                        break;
+                    case DisplayList::CommandType::String:
+                        HeadlessHost::drawStringPerPixel(renderer, list.getString(command.index), command.flags & 1, command.x, command.y, command.param, command.color, command.w);
+                        break;
+                    case DisplayList::CommandType::GlyphMask: {
+                        const Glyph& glyph = *static_cast<const Glyph*>(command.data);
+                        HeadlessHost::drawGlyphPerPixel(renderer, glyph, command.x + glyph.bounds[0], command.y + glyph.bounds[1], command.color);
+                        break;
+                    }
+                    case DisplayList::CommandType::PushScissor:
+                        renderer->enableScissoring(command.x, command.y, command.w, command.h);
+                        break;
+                    case DisplayList::CommandType::PopScissor:
+                        renderer->disableScissoring();
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+
+        inline void setFilter(const std::string& filter) {
+            this->m_filter = filter;
+        }
+
+        /**
+         * @brief Filled circle the way it was drawn before the scanline rasteriser, a distance test per pixel of the bounding box
+         * @note (2dx - 1)² + (2dy - 1)² <= 4r² selects exactly the pixels of the midpoint circle, so the result has to
+         *       match \ref Renderer::drawCircle pixel for pixel
+         *
+         * @param renderer Renderer
+         * @param centerX Center X pos
+         * @param centerY Center Y pos
+         * @param radius Radius
+         * @param color Color
+         */
+        static void drawCircleDistance(Renderer* renderer, const s32 centerX, const s32 centerY, const s32 radius, const Color& color) {
+            for (s32 dy = -radius; dy <= radius; ++dy) {
+                for (s32 dx = -radius; dx <= radius; ++dx) {
+                    if (HeadlessHost::isInsideCircle(dx, dy, radius))
+                        renderer->setPixelBlendDst(centerX + dx, centerY + dy, color);
+                }
+            }
+        }
+
+        /**
+         * @brief Filled quarter circle drawn with a distance test per pixel, see \ref drawCircleDistance
+         *
+         * @param renderer Renderer
+         * @param centerX Center X pos
+         * @param centerY Center Y pos
+         * @param radius Radius
+         * @param color Color
+         * @param quadrant 1 top-right, 2 top-left, 3 bottom-left, 4 bottom-right
+         */
+        static void drawQuarterCircleDistance(Renderer* renderer, const s32 centerX, const s32 centerY, const s32 radius, const Color& color, const int quadrant) {
+            const s32 signX = (quadrant == 2 || quadrant == 3) ? -1 : 1;
+            const s32 signY = (quadrant == 1 || quadrant == 2) ? -1 : 1;
+            for (s32 dy = 0; dy <= radius; ++dy) {
+                for (s32 dx = 0; dx <= radius; ++dx) {
+                    if (HeadlessHost::isInsideCircle(dx, dy, radius))
+                        renderer->setPixelBlendDst(centerX + signX * dx, centerY + signY * dy, color);
+                }
+            }
+        }
+
+        /**
+         * @brief Rounded rect drawn with a distance test per pixel of its corners, a radius of 0 gives a plain rect
+         *
+         * @param renderer Renderer
+         * @param x X pos
+         * @param y Y pos
+         * @param w Width
+         * @param h Height
+         * @param radius Corner radius
+         * @param color Color
+         */
+        static void drawRoundedRectDistance(Renderer* renderer, const s32 x, const s32 y, const s32 w, const s32 h, const s32 radius, const Color& color) {
+            const s32 xLeft = x + radius, xRight = x + w - radius;
+            const s32 yTop = y + radius, yBottom = y + h - radius;
+            s32 dx, dy;
+            for (s32 y1 = y; y1 < y + h; ++y1) {
+                dy = (y1 < yTop) ? yTop - y1 : (y1 >= yBottom) ? y1 - yBottom : 0;
+                for (s32 x1 = x; x1 < x + w; ++x1) {
+                    dx = (x1 < xLeft) ? xLeft - x1 : (x1 > xRight) ? x1 - xRight : 0;
+                    if (dx * dx + dy * dy <= radius * radius)
+                        renderer->setPixelBlendDst(x1, y1, color);
+                }
+            }
+        }
+
+        /**
+         * @brief Draws a string glyph by glyph and pixel by pixel, laid out like \ref Renderer::drawString
+         *
+         * @param renderer Renderer
+         * @param text Text
+         * @param monospace Draw monospaced
+         * @param x X pos of the pen
+         * @param y Y pos of the pen
+         * @param fontSize Height of the text in pixels
+         * @param color Text color
+         * @param maxWidth Width after which drawing stops, 0 for none
+         */
+        static void drawStringPerPixel(Renderer* renderer, const std::string& text, const bool monospace, const s32 x, const s32 y, const s32 fontSize, const Color& color, const s32 maxWidth) {
+            std::lock_guard<std::recursive_mutex> lock(renderer->m_textMutex);
+            const std::vector<u32> codepoints = Renderer::s_textRuns.get(text, fontSize, monospace).codepoints;
+
+            float currX = x, currY = y;
+            Glyph* glyph;
+            for (const u32 codepoint : codepoints) {
+                if (maxWidth > 0 && (currX - x) >= maxWidth)
+                    break;
+
+                if (codepoint == '\n') {
+                    currX = x;
+                    currY += fontSize;
+                    continue;
+                }
+
+                glyph = renderer->getGlyph(codepoint, monospace, fontSize);
+                if (!glyph->coverage.empty() && !std::iswspace(codepoint) && fontSize > 0)
+                    HeadlessHost::drawGlyphPerPixel(renderer, *glyph, static_cast<s32>(currX + glyph->bounds[0]), static_cast<s32>(currY + glyph->bounds[1]), color);
+                currX += static_cast<s32>(glyph->xAdvance * glyph->currFontSize);
+            }
+        }
+
+        /**
+         * @brief Draws glyph coverage pixel by pixel, full coverage replaces the pixel and partial coverage blends
+         *
+         * @param renderer Renderer
+         * @param glyph Glyph
+         * @param glyphX X pos of the glyph box
+         * @param glyphY Y pos of the glyph box
+         * @param color Text color
+         */
+        static void drawGlyphPerPixel(Renderer* renderer, const Glyph& glyph, const s32 glyphX, const s32 glyphY, const Color& color) {
+            u8 coverage;
+            u32 offset;
+            for (s32 bmpY = 0; bmpY < glyph.height; ++bmpY) {
+                for (s32 bmpX = 0; bmpX < glyph.width; ++bmpX) {
+                    coverage = glyph.getCoverage(bmpX, bmpY);
+                    if (coverage == 0xF) {
+                        offset = renderer->getPixelOffset(glyphX + bmpX, glyphY + bmpY);
+                        if (offset != UINT32_MAX)
+                            static_cast<u16*>(renderer->getCurrentFramebuffer())[offset] = color.rgba;
+                    } else if (coverage != 0x0) {
+                        renderer->setPixelBlendDst(glyphX + bmpX, glyphY + bmpY, Color(color.r, color.g, color.b, coverage));
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Drops every rasterized glyph, text layout and font metrics table, so the next string starts cold
+         */
+        static void clearTextCaches() {
+            Renderer::s_glyphAtlas.clear();
+            Renderer::s_textRuns.clear();
+            Renderer::get().m_fontMetrics.clear();
+        }
+
+    private:
+        /**
+         * @brief Draws a fully damaged frame and copies it out
+         *
+         * @param draw Draw calls
+         * @return Block linear framebuffer content
+         */
+        std::vector<u16> captureFrame(const Workload& draw) {
+            this->m_renderer.waitForRenderThread();
+            Renderer::invalidateAll();
+            this->m_renderer.startFrame();
+            draw(&this->m_renderer);
+            const u16* framebuffer = static_cast<const u16*>(this->m_renderer.getCurrentFramebuffer());
+            std::vector<u16> pixels(framebuffer, framebuffer + this->m_renderer.getFramebufferSize() / sizeof(u16));
+            this->m_renderer.endFrame();
+            return pixels;
+        }
+
+        static u64 countMismatches(const std::vector<u16>& pixels, const std::vector<u16>& expected) {
+            u64 mismatched = 0;
+            for (size_t i = 0; i < expected.size(); ++i)
+                mismatched += pixels[i] != expected[i];
+            return mismatched;
+        }
+
+        inline static bool isInsideCircle(const s32 dx, const s32 dy, const s32 radius) {
+            const s32 x = 2 * std::abs(dx) - 1, y = 2 * std::abs(dy) - 1;
+            return x * x + y * y <= 4 * radius * radius;
+        }
+
+        static constexpr u32 Samples = 9;
+        static constexpr u32 WarmupSamples = 2;
+        static constexpr u32 Iterations = 50;
+
+        Renderer& m_renderer;
+        std::string m_filter;
+    };
+
+}
+
+/**
+ * @brief Counts the glyphs a string draws, newlines and spaces are skipped by the renderer
+ *
+ * @param text Text
+ * @return Number of drawn glyphs
+ */
+static u64 countGlyphs(const std::string& text) {
+    u64 count = 0;
+    for (const char c : text) {
+        if (c != ' ' && c != '\n')
+            count++;
+    }
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    if (std::getenv("TESLA_HEADLESS_FONT") == nullptr) {
+        fprintf(stderr, "Set TESLA_HEADLESS_FONT to a TrueType font, e.g. the console's standard shared font\n");
+        return 1;
+    }
+
+    using tsl::gfx::Renderer;
+    tsl::gfx::HeadlessHost host;
+    if (argc > 1)
+        host.setFilter(argv[1]);
+
+    const tsl::Color opaque = { 0x2, 0x8, 0xC, 0xF };
+    const tsl::Color translucent = { 0x2, 0x8, 0xC, 0x9 };
+    const u64 screenPixels = 448 * 720;
+
+    // A frame using every pointer-backed command: bitmap, text strip glyph masks and a region read back and written elsewhere.
+    // Bitmaps hold one nibble per byte
+    std::vector<u8> badge(64 * 32 * 4);
+    for (size_t i = 0; i < badge.size(); i += 4) {
+        badge[i] = (i / 4) % 64 / 4;
+        badge[i + 1] = 0x8;
+        badge[i + 2] = (i / 4) / 64 / 2;
+        badge[i + 3] = 0xC;
+    }
+    bool roundTripOk = host.checkRoundTrip("displayList/roundTrip", [&](Renderer* renderer) {
+        renderer->fillScreen({ 0x0, 0x0, 0x0, 0xD });
+        renderer->drawRect(20, 20, 200, 40, translucent);
+        renderer->drawRoundedRect(20, 80, 400, 70, 12, translucent);
+        renderer->drawString("Ultrahand", false, 30, 130, 23, opaque);
+        renderer->drawTextStrip(renderer->renderTextStrip("Scrolling list item text", 23), 30, 200, opaque);
+        renderer->drawBitmap(300, 20, 64, 32, badge.data());
+
+        auto region = std::make_shared<std::vector<u16>>(448 * 97);
+        renderer->readRegion(region, 0, 0, 448, 97);
+        renderer->writeRegion(std::shared_ptr<const std::vector<u16>>(region), 0, 400, 448, 97);
+    });
+
+    // Track bars draw their bars as uniform rounded rects, which have to record like every other primitive
+    {
+        tsl::elm::TrackBar trackBar("Volume", "", 0, 100, "%");
+        trackBar.setBoundaries(35, 300, 448 - 85, tsl::style::TrackBarDefaultHeight);
+        roundTripOk &= host.checkRoundTrip("displayList/trackBar", [&](Renderer* renderer) {
+            renderer->fillScreen({ 0x0, 0x0, 0x0, 0xD });
+            trackBar.draw(renderer);
+        });
+    }
+
+    host.run("fillScreen", "px", screenPixels, [](Renderer* renderer) {
+        renderer->fillScreen({ 0x0, 0x0, 0x0, 0xD });
+    });
+
+    host.run("drawRect/opaque 400x60", "px", 400 * 60, [&](Renderer* renderer) {
+        renderer->drawRect(24, 200, 400, 60, opaque);
+    });
+    host.run("drawRect/translucent 400x60", "px", 400 * 60, [&](Renderer* renderer) {
+        renderer->drawRect(24, 200, 400, 60, translucent);
+    });
+
+    // Radii used by the theme: list items, buttons and track bar knobs
+    for (const s32 radius : { 2, 12, 13, 16 }) {
+        const std::string name = "drawRoundedRect/r" + std::to_string(radius) + " 400x70";
+        host.run(name.c_str(), "px", 400 * 70, [&](Renderer* renderer) {
+            renderer->drawRoundedRect(24, 200, 400, 70, radius, translucent);
+        });
+    }
+
+    // The same radii for circles and quarter circles (rounded rect corners, toggles, knobs), against the per-pixel
+    // distance test the scanline rasteriser replaced. Both have to cover the same pixels
+    bool circlesOk = true;
+    for (const u16 radius : { 2, 12, 13, 16 }) {
+        const std::string suffix = " r" + std::to_string(radius);
+        const u64 boxPixels = (2 * radius + 1) * (2 * radius + 1);
+        for (const tsl::Color& color : { opaque, translucent }) {
+            const std::string name = std::string("drawCircle/matches distance") + (color.a == 0xF ? " opaque" : "") + suffix;
+            circlesOk &= host.checkSamePixels(name.c_str(), [&](Renderer* renderer) {
+                renderer->fillScreen({ 0x0, 0x0, 0x0, 0xD });
+                tsl::gfx::HeadlessHost::drawCircleDistance(renderer, 224, 360, radius, color);
+                for (int quadrant = 1; quadrant <= 4; ++quadrant)
+                    tsl::gfx::HeadlessHost::drawQuarterCircleDistance(renderer, 100 + 40 * quadrant, 200, radius, color, quadrant);
+            }, [&](Renderer* renderer) {
+                renderer->fillScreen({ 0x0, 0x0, 0x0, 0xD });
+                renderer->drawCircle(224, 360, radius, true, color);
+                for (int quadrant = 1; quadrant <= 4; ++quadrant)
+                    renderer->drawQuarterCircle(100 + 40 * quadrant, 200, radius, true, color, quadrant);
+            });
+        }
+
+        host.run(("drawCircle/distance" + suffix).c_str(), "px", boxPixels, [&](Renderer* renderer) {
+            tsl::gfx::HeadlessHost::drawCircleDistance(renderer, 224, 360, radius, translucent);
+        });
+        host.run(("drawCircle/filled" + suffix).c_str(), "px", boxPixels, [&](Renderer* renderer) {
+            renderer->drawCircle(224, 360, radius, true, translucent);
+        });
+
+        // All four quadrants, as a rounded rect's corners
+        const u64 quarterPixels = 4 * (radius + 1) * (radius + 1);
+        host.run(("drawQuarterCircle/distance" + suffix).c_str(), "px", quarterPixels, [&](Renderer* renderer) {
+            for (int quadrant = 1; quadrant <= 4; ++quadrant)
+                tsl::gfx::HeadlessHost::drawQuarterCircleDistance(renderer, 224, 360, radius, translucent, quadrant);
+        });
+        host.run(("drawQuarterCircle/filled" + suffix).c_str(), "px", quarterPixels, [&](Renderer* renderer) {
+            for (int quadrant = 1; quadrant <= 4; ++quadrant)
+                renderer->drawQuarterCircle(224, 360, radius, true, translucent, quadrant);
+        });
+    }
+
+    for (const u16 radius : { 8, 40, 160 }) {
+        const std::string name = "drawCircle/filled r" + std::to_string(radius);
+        const u64 boxPixels = (2 * radius + 1) * (2 * radius + 1);
+        host.run(name.c_str(), "px", boxPixels, [&](Renderer* renderer) {
+            renderer->drawCircle(224, 360, radius, true, translucent);
+        });
+    }
+    host.run("drawCircle/outline r40", "px", 81 * 81, [&](Renderer* renderer) {
+        renderer->drawCircle(224, 360, 40, false, translucent);
+    });
+
+    bool listOk = true;
+    // 50 list items in the viewport of an OverlayFrame, scrolled so items get cut at both edges of the list's scissor
+    {
+        tsl::elm::List list;
+        list.setBoundaries(35, 97, 448 - 85, 720 - 73 - 105);
+        for (u32 i = 0; i < 50; ++i)
+            list.addItem(new tsl::elm::ListItem("List item " + std::to_string(i + 1), i % 3 == 0 ? "Value" : ""));
+
+        // Items join the list on its first frame. A scroll offset gets applied by one frame and laid out for the next
+        const auto drawList = [&list](Renderer* renderer) { list.frame(renderer); };
+        host.frame(drawList);
+        tsl::elm::Element::setInputMode(tsl::InputMode::TouchScroll);
+        list.onTouch(tsl::elm::TouchEvent::Scroll, 200, 300, 200, 300 + 1030, 200, 300);
+        host.frame(drawList);
+        host.frame(drawList);
+
+        // The same frame drawn pixel by pixel through the per-pixel clip test, as before primitives got clipped up front
+        tsl::gfx::DisplayList recorded;
+        host.record(recorded, drawList);
+        const auto drawPerPixel = [&recorded](Renderer* renderer) { tsl::gfx::HeadlessHost::replayPerPixel(renderer, recorded); };
+        const u64 listPixels = list.getWidth() * list.getHeight();
+        listOk = host.checkSamePixels("List/per pixel matches", drawList, drawPerPixel);
+        host.run("List/50 items scrolled", "px", listPixels, drawList);
+        host.run("List/50 items scrolled per pixel", "px", listPixels, drawPerPixel);
+        tsl::elm::Element::setInputMode(tsl::InputMode::Controller);
+    }
+
+    // A wallpaper sized gradient, both as packed wallpaper and as bitmap with one nibble per byte
+    std::vector<u8> bitmap(screenPixels * 4);
+    wallpaperData.resize(screenPixels);
+    for (s32 y = 0; y < 720; ++y) {
+        for (s32 x = 0; x < 448; ++x) {
+            u8* pixel = &bitmap[(y * 448 + x) * 4];
+            pixel[0] = (x * 255 / 447) >> 4;
+            pixel[1] = (y * 255 / 719) >> 4;
+            pixel[2] = ((x + y) & 0xFF) >> 4;
+            pixel[3] = 0xF;
+            wallpaperData[getPackedWallpaperOffset(x, y)] = pixel[0] | (pixel[1] << 4) | (pixel[2] << 8) | 0xF000;
+        }
+    }
+
+    wallpaperOpaque = true;
+    host.run("drawWallpaper/opaque", "px", screenPixels, [](Renderer* renderer) {
+        renderer->drawWallpaper({ 0x0, 0x0, 0x0, 0xF });
+    });
+    wallpaperOpaque = false;
+    host.run("drawWallpaper/translucent", "px", screenPixels, [](Renderer* renderer) {
+        renderer->drawWallpaper({ 0x0, 0x0, 0x0, 0xD });
+    });
+    host.run("drawBitmap/448x720", "px", screenPixels, [&](Renderer* renderer) {
+        renderer->drawBitmap(0, 0, 448, 720, bitmap.data());
+    });
+    wallpaperData.clear();
+
+    const std::string text = "The quick brown fox jumps over the lazy dog 0123456789";
+    const u64 glyphs = countGlyphs(text);
+
+    host.run("drawString/cold 23px", "glyph", glyphs, [&](Renderer* renderer) {
+        renderer->drawString(text, false, 20, 300, 23, opaque);
+    }, [](Renderer*) {
+        tsl::gfx::HeadlessHost::clearTextCaches();
+    });
+    host.run("drawString/warm 23px", "glyph", glyphs, [&](Renderer* renderer) {
+        renderer->drawString(text, false, 20, 300, 23, opaque);
+    });
+
+    host.run("calculateStringWidth/cold 23px", "glyph", glyphs, [&](Renderer* renderer) {
+        renderer->calculateStringWidth(text, 23);
+    }, [](Renderer*) {
+        tsl::gfx::HeadlessHost::clearTextCaches();
+    });
+    host.run("calculateStringWidth/warm 23px", "glyph", glyphs, [&](Renderer* renderer) {
+        renderer->calculateStringWidth(text, 23);
+    });
+
+    return (roundTripOk && circlesOk && listOk) ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+/********************************************************************************
+ * File: debug_funcs.hpp
+ * Description:
+ *   Host stand-in for libultra's logging, see switch.h. Log lines go to stderr.
+ ********************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+inline bool disableLogging = false;
+
+inline void logMessage(const std::string& message) {
+    if (!disableLogging)
+        fprintf(stderr, "%s\n", message.c_str());
+}
@@ -0,0 +1,14 @@
+/********************************************************************************
+ * File: download_funcs.hpp
+ * Description:
+ *   Host stand-in for libultra's download progress counters. Nothing gets
+ *   downloaded on the host, the counters stay idle.
+ ********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+inline std::atomic<int> downloadPercentage(-1);
+inline std::atomic<int> unzipPercentage(-1);
+inline std::atomic<int> copyPercentage(-1);
@@ -0,0 +1,17 @@
+/********************************************************************************
+ * File: get_funcs.hpp
+ * Description:
+ *   Host stand-in for the libultra path getters tesla.hpp uses.
+ ********************************************************************************/
+
+#pragma once
+
+#include <string>
+
+inline std::string getNameFromPath(const std::string& path) {
+    const size_t end = path.find_last_not_of('/');
+    if (end == std::string::npos)
+        return "";
+    const size_t start = path.find_last_of('/', end);
+    return path.substr(start == std::string::npos ? 0 : start + 1, end - (start == std::string::npos ? 0 : start + 1) + 1);
+}
@@ -0,0 +1,7 @@
+/********************************************************************************
+ * File: hex_funcs.hpp
+ * Description:
+ *   Host stand-in for libultra's hex_funcs.hpp. tesla.hpp uses none of it.
+ ********************************************************************************/
+
+#pragma once
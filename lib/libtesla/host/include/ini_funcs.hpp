@@ -0,0 +1,70 @@
+/********************************************************************************
+ * File: ini_funcs.hpp
+ * Description:
+ *   Host stand-in for the libultra INI helpers tesla.hpp uses, reading and
+ *   writing plain files on the host.
+ ********************************************************************************/
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+inline std::string trimIniToken(const std::string& str) {
+    const size_t start = str.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos)
+        return "";
+    return str.substr(start, str.find_last_not_of(" \t\r\n") - start + 1);
+}
+
+inline std::map<std::string, std::map<std::string, std::string>> parseIni(const std::string& str) {
+    std::map<std::string, std::map<std::string, std::string>> iniData;
+    std::istringstream stream(str);
+    std::string line, section;
+    while (std::getline(stream, line)) {
+        line = trimIniToken(line);
+        if (line.empty() || line[0] == ';' || line[0] == '#')
+            continue;
+        if (line.front() == '[' && line.back() == ']') {
+            section = line.substr(1, line.size() - 2);
+        } else if (const size_t equals = line.find('='); equals != std::string::npos) {
+            iniData[section][trimIniToken(line.substr(0, equals))] = trimIniToken(line.substr(equals + 1));
+        }
+    }
+    return iniData;
+}
+
+inline std::map<std::string, std::map<std::string, std::string>> getParsedDataFromIniFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        return {};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return parseIni(contents.str());
+}
+
+inline std::map<std::string, std::string> getKeyValuePairsFromSection(const std::string& path, const std::string& section) {
+    return getParsedDataFromIniFile(path)[section];
+}
+
+inline std::string parseValueFromIniSection(const std::string& path, const std::string& section, const std::string& key) {
+    auto iniData = getParsedDataFromIniFile(path);
+    return iniData[section][key];
+}
+
+inline void setIniFileValue(const std::string& path, const std::string& section, const std::string& key, const std::string& value) {
+    auto iniData = getParsedDataFromIniFile(path);
+    iniData[section][key] = value;
+
+    std::ofstream file(path);
+    if (!file)
+        return;
+    for (const auto& [name, entries] : iniData) {
+        file << '[' << name << "]\n";
+        for (const auto& [entryKey, entryValue] : entries)
+            file << entryKey << " = " << entryValue << '\n';
+        file << '\n';
+    }
+}
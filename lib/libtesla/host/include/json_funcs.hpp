@@ -0,0 +1,23 @@
+/********************************************************************************
+ * File: json_funcs.hpp
+ * Description:
+ *   Host stand-in for libultra's jansson based JSON helpers. No JSON library is
+ *   linked on the host, so language files never load and the built in English
+ *   strings are used.
+ ********************************************************************************/
+
+#pragma once
+
+#include <string>
+
+typedef struct json_t json_t;
+
+inline json_t* readJsonFromFile(const std::string&) {
+    return nullptr;
+}
+
+inline std::string getStringFromJson(const json_t*, const char*) {
+    return "";
+}
+
+inline void json_decref(json_t*) {}
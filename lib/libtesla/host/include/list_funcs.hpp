@@ -0,0 +1,7 @@
+/********************************************************************************
+ * File: list_funcs.hpp
+ * Description:
+ *   Host stand-in for libultra's list_funcs.hpp. tesla.hpp uses none of it.
+ ********************************************************************************/
+
+#pragma once
@@ -0,0 +1,7 @@
+/********************************************************************************
+ * File: mod_funcs.hpp
+ * Description:
+ *   Host stand-in for libultra's mod_funcs.hpp. tesla.hpp uses none of it.
+ ********************************************************************************/
+
+#pragma once
@@ -0,0 +1,20 @@
+/********************************************************************************
+ * File: path_funcs.hpp
+ * Description:
+ *   Host stand-in for the libultra file system helpers tesla.hpp uses.
+ ********************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+
+inline bool isFileOrDirectory(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+inline void deleteFileOrDirectory(const std::string& path) {
+    std::remove(path.c_str());
+}
@@ -0,0 +1,80 @@
+/********************************************************************************
+ * File: string_funcs.hpp
+ * Description:
+ *   Host stand-in for the libultra string helpers tesla.hpp uses.
+ ********************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <switch.h>
+
+inline std::string removeWhiteSpaces(const std::string& str) {
+    std::string result;
+    result.reserve(str.size());
+    for (const char c : str) {
+        if (!std::isspace(static_cast<unsigned char>(c)))
+            result += c;
+    }
+    return result;
+}
+
+inline void removeQuotes(std::string& str) {
+    if (str.size() >= 2 && (str.front() == '\'' || str.front() == '"') && str.back() == str.front())
+        str = str.substr(1, str.size() - 2);
+}
+
+inline void removeTag(std::string& str) {
+    const size_t start = str.find('<');
+    const size_t end = str.find('>', start);
+    if (start != std::string::npos && end != std::string::npos)
+        str.erase(start, end - start + 1);
+}
+
+inline std::vector<std::string> split(const std::string& str, const char delim = ' ') {
+    std::vector<std::string> tokens;
+    size_t start = 0;
+    for (size_t end; (end = str.find(delim, start)) != std::string::npos; start = end + 1)
+        tokens.push_back(str.substr(start, end - start));
+    tokens.push_back(str.substr(start));
+    return tokens;
+}
+
+/**
+ * @brief Decodes one UTF-8 sequence, like libnx's decode_utf8
+ *
+ * @param out Decoded codepoint
+ * @param in Sequence
+ * @return Length of the sequence, -1 if it is invalid
+ */
+inline ssize_t decode_utf8(u32* out, const u8* in) {
+    const u8 c = in[0];
+    const int length = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+    if (length == 0)
+        return -1;
+
+    u32 codepoint = length == 1 ? c : c & (0x7F >> length);
+    for (int i = 1; i < length; ++i) {
+        if ((in[i] & 0xC0) != 0x80)
+            return -1;
+        codepoint = (codepoint << 6) | (in[i] & 0x3F);
+    }
+    *out = codepoint;
+    return length;
+}
+
+// Loader info looks like "nx-ovlloader+ v1.0.8"
+inline std::string extractTitle(const std::string& input) {
+    const size_t end = input.find(' ');
+    return end == std::string::npos ? input : input.substr(0, end);
+}
+
+inline std::string cleanVersionLabel(const std::string& input) {
+    std::string version;
+    for (const char c : input.substr(input.find(' ') == std::string::npos ? 0 : input.find(' ') + 1)) {
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+            version += c;
+    }
+    return version;
+}
@@ -0,0 +1,419 @@
+/********************************************************************************
+ * File: switch.h
+ * Description:
+ *   Host stand-in for libnx, used by the headless builds of tesla.hpp
+ *   (USING_HEADLESS_DIRECTIVE) on a plain Linux box.
+ *
+ *   Provides the libnx types, constants and the service calls tesla.hpp
+ *   references. Services are stubs: they succeed and report an idle console
+ *   (no input, no touches, full battery). Events and threads are backed by the
+ *   C++ standard library, so the render, raster and prewarm threads run for
+ *   real. The rendering itself never touches any of this, the headless
+ *   renderer owns its framebuffers.
+ ********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Types
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t   s8;
+typedef int16_t  s16;
+typedef int32_t  s32;
+typedef int64_t  s64;
+typedef volatile u32 vu32;
+typedef u32 Result;
+typedef u32 Handle;
+
+#define BIT(n) (1U << (n))
+#define BITL(n) (1UL << (n))
+
+// Results
+
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_FAILED(res) ((res) != 0)
+#define MAKERESULT(module, description) ((((module) & 0x1FF)) | ((description) & 0x1FFF) << 9)
+#define KERNELRESULT(description) MAKERESULT(Module_Kernel, KernelError_##description)
+
+enum { Module_Kernel = 1 };
+enum { KernelError_TimedOut = 117 };
+
+[[noreturn]] inline void fatalThrow(Result res) {
+    fprintf(stderr, "fatal: 0x%X\n", res);
+    std::abort();
+}
+
+// Time
+
+inline u64 armGetSystemTick() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() * 192 / 10000;
+}
+
+inline u64 armTicksToNs(u64 tick) {
+    return tick * 10000 / 192;
+}
+
+inline u64 armNsToTicks(u64 ns) {
+    return ns * 192 / 10000;
+}
+
+inline void svcSleepThread(s64 ns) {
+    if (ns > 0)
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+}
+
+extern "C" inline void __libnx_init_time(void) {}
+inline Result timeInitialize() { return 0; }
+inline void timeExit() {}
+
+inline bool hosversionAtLeast(u8, u8, u8) {
+    return true;
+}
+
+// Service manager and sessions
+
+typedef struct { Handle session; } Service;
+
+inline Result smInitialize() { return 0; }
+inline void smExit() {}
+
+template<typename T>
+inline Result serviceDispatchIn(Service*, u32, const T&) {
+    return 0;
+}
+
+// Events
+
+struct Event {
+    struct State {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool signaled = false;
+        bool autoclear = false;
+    };
+    State* state;
+};
+
+inline Result eventCreate(Event* event, bool autoclear) {
+    event->state = new Event::State;
+    event->state->autoclear = autoclear;
+    return 0;
+}
+
+inline void eventClose(Event* event) {
+    delete event->state;
+    event->state = nullptr;
+}
+
+inline Result eventFire(Event* event) {
+    if (event->state == nullptr)
+        return 0;
+    {
+        std::lock_guard<std::mutex> lock(event->state->mutex);
+        event->state->signaled = true;
+    }
+    event->state->cv.notify_all();
+    return 0;
+}
+
+inline Result eventClear(Event* event) {
+    if (event->state != nullptr) {
+        std::lock_guard<std::mutex> lock(event->state->mutex);
+        event->state->signaled = false;
+    }
+    return 0;
+}
+
+inline Result eventWait(Event* event, u64 timeout) {
+    if (event->state == nullptr) {
+        svcSleepThread(timeout == UINT64_MAX ? 0 : timeout);
+        return KERNELRESULT(TimedOut);
+    }
+
+    std::unique_lock<std::mutex> lock(event->state->mutex);
+    const auto signaled = [event] { return event->state->signaled; };
+    if (timeout == UINT64_MAX)
+        event->state->cv.wait(lock, signaled);
+    else if (!event->state->cv.wait_for(lock, std::chrono::nanoseconds(timeout), signaled))
+        return KERNELRESULT(TimedOut);
+
+    if (event->state->autoclear)
+        event->state->signaled = false;
+    return 0;
+}
+
+typedef struct { Event* event; } Waiter;
+
+inline Waiter waiterForEvent(Event* event) {
+    return { event };
+}
+
+inline Result waitObjects(s32* idx, const Waiter* objects, s32 count, u64 timeout) {
+    // Only the console's buttons are waited on, none of them gets pressed on the host
+    (void)objects; (void)count;
+    *idx = -1;
+    svcSleepThread(timeout);
+    return KERNELRESULT(TimedOut);
+}
+
+// Threads
+
+typedef void (*ThreadFunc)(void*);
+
+struct Thread {
+    std::thread* thread;
+    ThreadFunc entry;
+    void* arg;
+};
+
+inline Result threadCreate(Thread* t, ThreadFunc entry, void* arg, void*, size_t, int, int) {
+    t->thread = nullptr;
+    t->entry = entry;
+    t->arg = arg;
+    return 0;
+}
+
+inline Result threadStart(Thread* t) {
+    t->thread = new std::thread(t->entry, t->arg);
+    return 0;
+}
+
+inline Result threadWaitForExit(Thread* t) {
+    if (t->thread != nullptr && t->thread->joinable())
+        t->thread->join();
+    return 0;
+}
+
+inline Result threadClose(Thread* t) {
+    delete t->thread;
+    t->thread = nullptr;
+    return 0;
+}
+
+// Applet and loader environment
+
+enum AppletType { AppletType_None = -2 };
+
+inline const char* envGetLoaderInfo() {
+    return "nx-ovlloader+ v1.0.8\n";
+}
+
+inline Result envSetNextLoad(const char*, const char*) {
+    return 0;
+}
+
+// hid
+
+enum HidNpadButton : u64 {
+    HidNpadButton_A           = BITL(0),
+    HidNpadButton_B           = BITL(1),
+    HidNpadButton_X           = BITL(2),
+    HidNpadButton_Y           = BITL(3),
+    HidNpadButton_StickL      = BITL(4),
+    HidNpadButton_StickR      = BITL(5),
+    HidNpadButton_L           = BITL(6),
+    HidNpadButton_R           = BITL(7),
+    HidNpadButton_ZL          = BITL(8),
+    HidNpadButton_ZR          = BITL(9),
+    HidNpadButton_Plus        = BITL(10),
+    HidNpadButton_Minus       = BITL(11),
+    HidNpadButton_Left        = BITL(12),
+    HidNpadButton_Up          = BITL(13),
+    HidNpadButton_Right       = BITL(14),
+    HidNpadButton_Down        = BITL(15),
+    HidNpadButton_StickLLeft  = BITL(16),
+    HidNpadButton_StickLUp    = BITL(17),
+    HidNpadButton_StickLRight = BITL(18),
+    HidNpadButton_StickLDown  = BITL(19),
+    HidNpadButton_StickRLeft  = BITL(20),
+    HidNpadButton_StickRUp    = BITL(21),
+    HidNpadButton_StickRRight = BITL(22),
+    HidNpadButton_StickRDown  = BITL(23),
+    HidNpadButton_LeftSL      = BITL(24),
+    HidNpadButton_LeftSR      = BITL(25),
+    HidNpadButton_RightSL     = BITL(26),
+    HidNpadButton_RightSR     = BITL(27),
+
+    HidNpadButton_AnyLeft  = HidNpadButton_Left  | HidNpadButton_StickLLeft  | HidNpadButton_StickRLeft,
+    HidNpadButton_AnyUp    = HidNpadButton_Up    | HidNpadButton_StickLUp    | HidNpadButton_StickRUp,
+    HidNpadButton_AnyRight = HidNpadButton_Right | HidNpadButton_StickLRight | HidNpadButton_StickRRight,
+    HidNpadButton_AnyDown  = HidNpadButton_Down  | HidNpadButton_StickLDown  | HidNpadButton_StickRDown,
+    HidNpadButton_AnySL    = HidNpadButton_LeftSL | HidNpadButton_RightSL,
+    HidNpadButton_AnySR    = HidNpadButton_LeftSR | HidNpadButton_RightSR,
+};
+
+enum {
+    HidNpadStyleTag_NpadFullKey   = BIT(0),
+    HidNpadStyleTag_NpadHandheld  = BIT(1),
+    HidNpadStyleTag_NpadJoyDual   = BIT(2),
+    HidNpadStyleTag_NpadJoyLeft   = BIT(3),
+    HidNpadStyleTag_NpadJoyRight  = BIT(4),
+    HidNpadStyleTag_NpadSystemExt = BIT(29),
+    HidNpadStyleSet_NpadStandard  = HidNpadStyleTag_NpadFullKey | HidNpadStyleTag_NpadHandheld | HidNpadStyleTag_NpadJoyDual |
+                                    HidNpadStyleTag_NpadJoyLeft | HidNpadStyleTag_NpadJoyRight,
+};
+
+typedef struct {
+    s32 x;
+    s32 y;
+} HidAnalogStickState;
+
+typedef struct {
+    u64 delta_time;
+    u32 attributes;
+    u32 finger_id;
+    u32 x;
+    u32 y;
+    u32 diameter_x;
+    u32 diameter_y;
+    u32 rotation_angle;
+    u32 reserved;
+} HidTouchState;
+
+typedef struct {
+    u64 sampling_number;
+    s32 count;
+    u32 reserved;
+    HidTouchState touches[16];
+} HidTouchScreenState;
+
+typedef struct {
+    u64 buttons_cur;
+    u64 buttons_old;
+    HidAnalogStickState sticks[2];
+} PadState;
+
+inline Result hidInitialize() { return 0; }
+inline void hidExit() {}
+inline void hidInitializeTouchScreen() {}
+
+inline size_t hidGetTouchScreenStates(HidTouchScreenState* states, size_t count) {
+    std::memset(states, 0, sizeof(HidTouchScreenState) * count);
+    return 0;
+}
+
+inline void padConfigureInput(u32, u32) {}
+inline void padInitializeAny(PadState* pad) { std::memset(pad, 0, sizeof(PadState)); }
+inline void padUpdate(PadState* pad) { pad->buttons_old = pad->buttons_cur; }
+inline u64 padGetButtons(const PadState* pad) { return pad->buttons_cur; }
+inline u64 padGetButtonsDown(const PadState* pad) { return pad->buttons_cur & ~pad->buttons_old; }
+inline HidAnalogStickState padGetStickPos(const PadState* pad, unsigned i) { return pad->sticks[i]; }
+
+inline Result hidsysInitialize() { return 0; }
+inline void hidsysExit() {}
+inline Service* hidsysGetServiceSession() { static Service service; return &service; }
+inline Result hidsysAcquireHomeButtonEventHandle(Event* event, bool autoclear) { return eventCreate(event, autoclear); }
+inline Result hidsysAcquireSleepButtonEventHandle(Event* event, bool autoclear) { return eventCreate(event, autoclear); }
+inline Result hidsysAcquireCaptureButtonEventHandle(Event* event, bool autoclear) { return eventCreate(event, autoclear); }
+
+// vi, the headless renderer doesn't create a layer
+
+typedef enum {
+    ViLayerFlags_None = 0,
+    ViLayerFlags_Default = BIT(0),
+} ViLayerFlags;
+
+// fs, backed by the host file system
+
+typedef struct { int unused; } FsFileSystem;
+typedef struct { FILE* file; } FsFile;
+
+enum { FsOpenMode_Read = BIT(0), FsOpenMode_Write = BIT(1), FsOpenMode_Append = BIT(2) };
+enum { FsReadOption_None = 0 };
+enum { FsWriteOption_None = 0, FsWriteOption_Flush = BIT(0) };
+
+inline Result fsInitialize() { return 0; }
+inline void fsExit() {}
+inline Result fsdevMountSdmc() { return 0; }
+inline Result fsdevUnmountDevice(const char*) { return 0; }
+inline Result fsOpenSdCardFileSystem(FsFileSystem*) { return 0; }
+inline void fsFsClose(FsFileSystem*) {}
+
+inline Result fsFsOpenFile(FsFileSystem*, const char* path, u32 mode, FsFile* out) {
+    out->file = std::fopen(path, (mode & FsOpenMode_Write) ? "r+b" : "rb");
+    return out->file != nullptr ? 0 : 1;
+}
+
+inline void fsFileClose(FsFile* file) {
+    if (file->file != nullptr)
+        std::fclose(file->file);
+    file->file = nullptr;
+}
+
+inline Result fsFileGetSize(FsFile* file, s64* out) {
+    if (std::fseek(file->file, 0, SEEK_END) != 0)
+        return 1;
+    *out = std::ftell(file->file);
+    return 0;
+}
+
+inline Result fsFileRead(FsFile* file, s64 offset, void* buffer, u64 size, u32, u64* bytesRead) {
+    if (std::fseek(file->file, offset, SEEK_SET) != 0)
+        return 1;
+    *bytesRead = std::fread(buffer, 1, size, file->file);
+    return 0;
+}
+
+inline Result fsFileWrite(FsFile* file, s64 offset, const void* buffer, u64 size, u32) {
+    if (std::fseek(file->file, offset, SEEK_SET) != 0)
+        return 1;
+    return std::fwrite(buffer, 1, size, file->file) == size ? 0 : 1;
+}
+
+// pl, set and the other services the overlay initializes
+
+typedef enum { PlServiceType_User = 0, PlServiceType_System = 1 } PlServiceType;
+
+inline Result plInitialize(PlServiceType) { return 0; }
+inline void plExit() {}
+inline Result setInitialize() { return 0; }
+inline void setExit() {}
+inline Result setsysInitialize() { return 0; }
+inline void setsysExit() {}
+inline Result pmdmntInitialize() { return 0; }
+inline void pmdmntExit() {}
+inline Result pmdmntGetProcessId(u64* pid, u64) { *pid = 0; return 0; }
+inline Result pmdmntGetApplicationProcessId(u64* pid) { *pid = 0; return 1; }
+inline Result pminfoInitialize() { return 0; }
+inline void pminfoExit() {}
+inline Result pminfoGetProgramId(u64* programId, u64) { *programId = 0; return 1; }
+
+// psm
+
+typedef struct { Service s; Event StateChangeEvent; } PsmSession;
+
+typedef enum {
+    PsmChargerType_Unconnected = 0,
+    PsmChargerType_EnoughPower = 1,
+    PsmChargerType_LowPower = 2,
+    PsmChargerType_NotSupported = 3,
+} PsmChargerType;
+
+inline Result psmInitialize() { return 0; }
+inline void psmExit() {}
+inline Result psmBindStateChangeEvent(PsmSession*, bool, bool, bool) { return 0; }
+inline Result psmUnbindStateChangeEvent(PsmSession*) { return 0; }
+inline Result psmGetBatteryChargePercentage(u32* out) { *out = 100; return 0; }
+inline Result psmGetChargerType(PsmChargerType* out) { *out = PsmChargerType_Unconnected; return 0; }
+
+// i2c, the temperature sensor reads fail on the host
+
+typedef enum { I2cDevice_Tmp451 = 14 } I2cDevice;
+typedef enum { I2cTransactionOption_Start = BIT(0), I2cTransactionOption_Stop = BIT(1), I2cTransactionOption_All = BIT(0) | BIT(1) } I2cTransactionOption;
+typedef struct { Service s; } I2cSession;
+
+inline Result i2cOpenSession(I2cSession*, I2cDevice) { return 1; }
+inline Result i2csessionExecuteCommandList(I2cSession*, void*, size_t, const void*, size_t) { return 1; }
+inline void i2csessionClose(I2cSession*) {}
@@ -42,11 +42,14 @@
 
 #include <ultra.hpp>
 #include <switch.h>
+#if defined(__ARM_NEON)
 #include <arm_neon.h>
+#endif
 
 #include <stdlib.h>
 #include <strings.h>
 #include <math.h>
+#include <sys/stat.h>
 
 #include <algorithm>
 #include <cstring>
@@ -55,11 +58,14 @@
 #include <functional>
 #include <type_traits>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <memory>
 #include <chrono>
 #include <list>
 #include <stack>
 #include <map>
+#include <unordered_set>
 
 
 //static bool debugFPS = true;
@@ -151,6 +157,7 @@ bool disableTransparency = false;
 //bool useCustomWallpaper = false;
 bool useMemoryExpansion = false;
 bool useOpaqueScreenshots = false;
+bool useFrameProfiler = false;
 
 bool onTrackBar = false;
 bool allowSlide = false;
@@ -275,7 +282,9 @@ void convertComboToUnicode(std::string& combo);
 const std::string whiteColor = "#FFFFFF";
 const std::string blackColor = "#000000";
 
+#ifndef M_PI
 constexpr float M_PI = 3.14159265358979323846;
+#endif
 constexpr float RAD_TO_DEG = 180.0f / M_PI;
 
 static std::string ENGLISH = "English";
@@ -350,6 +359,7 @@ static std::string CLEAN_VERSIONS = "Clean Versions";
 static std::string OVERLAY_VERSIONS = "Overlay Versions";
 static std::string PACKAGE_VERSIONS = "Package Versions";
 static std::string OPAQUE_SCREENSHOTS = "Opaque Screenshots";
+static std::string FRAME_PROFILER = "Frame Profiler";
 static std::string ON = "On";
 static std::string OFF = "Off";
 static std::string PACKAGE_INFO = "Package Info";
@@ -422,8 +432,49 @@ static std::string OCT = "Oct";
 static std::string NOV = "Nov";
 static std::string DEC = "Dec";
 
+// Every string loaded by parseLanguage, its glyphs get rasterized ahead of time
+static std::string languageGlyphText;
+
+// Day and month names as strftime writes them and their translations, full names first so "Sunday" is never
+// taken for "Sun". Empty while the English defaults are active
+static std::vector<std::pair<std::string, std::string>> timeStrReplacements;
+
+// Exact replacements done by applyLangReplacements() for labels and for values
+static std::unordered_map<std::string, std::string> langTextReplacements, langValueReplacements;
+
+/**
+ * @brief Rebuilds the lookup tables of localizeTimeStr() and applyLangReplacements() from the current language strings
+ */
+void buildLocalizationMaps() {
+    // "May" is both a full and an abbreviated month name, its abbreviation has always been used
+    timeStrReplacements = {
+        {"Sunday", SUNDAY}, {"Monday", MONDAY}, {"Tuesday", TUESDAY}, {"Wednesday", WEDNESDAY},
+        {"Thursday", THURSDAY}, {"Friday", FRIDAY}, {"Saturday", SATURDAY},
+        {"January", JANUARY}, {"February", FEBRUARY}, {"March", MARCH}, {"April", APRIL},
+        {"June", JUNE}, {"July", JULY}, {"August", AUGUST}, {"September", SEPTEMBER},
+        {"October", OCTOBER}, {"November", NOVEMBER}, {"December", DECEMBER},
+        {"Sun", SUN}, {"Mon", MON}, {"Tue", TUE}, {"Wed", WED}, {"Thu", THU}, {"Fri", FRI}, {"Sat", SAT},
+        {"Jan", JAN}, {"Feb", FEB}, {"Mar", MAR}, {"Apr", APR}, {"May", MAY_ABBR}, {"Jun", JUN},
+        {"Jul", JUL}, {"Aug", AUG}, {"Sep", SEP}, {"Oct", OCT}, {"Nov", NOV}, {"Dec", DEC}
+    };
+    if (std::all_of(timeStrReplacements.begin(), timeStrReplacements.end(), [](const auto& mapping) { return mapping.first == mapping.second; }))
+        timeStrReplacements.clear();
+
+    langTextReplacements = {
+        {"Reboot To", REBOOT_TO},
+        {"Boot Entry", BOOT_ENTRY},
+        {"Reboot", REBOOT},
+        {"Shutdown", SHUTDOWN}
+    };
+    langValueReplacements = {
+        {"On", ON},
+        {"Off", OFF}
+    };
+}
+
 // Constant string definitions (English)
 void reinitializeLangVars() {
+    languageGlyphText.clear();
     ENGLISH = "English";
     SPANISH = "Spanish";
     FRENCH = "French";
@@ -496,6 +547,7 @@ void reinitializeLangVars() {
     OVERLAY_VERSIONS = "Overlay Versions";
     PACKAGE_VERSIONS = "Package Versions";
     OPAQUE_SCREENSHOTS = "Opaque Screenshots";
+    FRAME_PROFILER = "Frame Profiler";
     ON = "On";
     OFF = "Off";
     PACKAGE_INFO = "Package Info";
@@ -567,6 +619,8 @@ void reinitializeLangVars() {
     OCT = "Oct";
     NOV = "Nov";
     DEC = "Dec";
+
+    buildLocalizationMaps();
 }
 
 
@@ -657,6 +711,7 @@ void parseLanguage(const std::string langFile) {
         {"OVERLAY_VERSIONS", &OVERLAY_VERSIONS},
         {"PACKAGE_VERSIONS", &PACKAGE_VERSIONS},
         {"OPAQUE_SCREENSHOTS", &OPAQUE_SCREENSHOTS},
+        {"FRAME_PROFILER", &FRAME_PROFILER},
         {"ON", &ON},
         {"OFF", &OFF},
         {"PACKAGE_INFO", &PACKAGE_INFO},
@@ -727,8 +782,10 @@ void parseLanguage(const std::string langFile) {
     };
 
     // Iterate over the map to update global variables
+    languageGlyphText.clear();
     for (auto& kv : configMap) {
         updateIfNotEmpty(*kv.second, kv.first.c_str(), langData);
+        languageGlyphText += *kv.second;
     }
 
     // Free langData
@@ -736,6 +793,8 @@ void parseLanguage(const std::string langFile) {
         json_decref(langData);
         langData = nullptr;
     }
+
+    buildLocalizationMaps();
 }
 
 
@@ -751,85 +810,40 @@ void parseLanguage(const std::string langFile) {
 //    }
 //}
 
-void localizeTimeStr(char* timeStr) {
-    // Define static unordered_map for day and month mappings
-    std::unordered_map<std::string, std::string> mappings = {
-        {"Sun", SUN},
-        {"Mon", MON},
-        {"Tue", TUE},
-        {"Wed", WED},
-        {"Thu", THU},
-        {"Fri", FRI},
-        {"Sat", SAT},
-        {"Sunday", SUNDAY},
-        {"Monday", MONDAY},
-        {"Tuesday", TUESDAY},
-        {"Wednesday", WEDNESDAY},
-        {"Thursday", THURSDAY},
-        {"Friday", FRIDAY},
-        {"Saturday", SATURDAY},
-        {"Jan", JAN},
-        {"Feb", FEB},
-        {"Mar", MAR},
-        {"Apr", APR},
-        {"May", MAY_ABBR},
-        {"Jun", JUN},
-        {"Jul", JUL},
-        {"Aug", AUG},
-        {"Sep", SEP},
-        {"Oct", OCT},
-        {"Nov", NOV},
-        {"Dec", DEC},
-        {"January", JANUARY},
-        {"February", FEBRUARY},
-        {"March", MARCH},
-        {"April", APRIL},
-        {"May", MAY},
-        {"June", JUNE},
-        {"July", JULY},
-        {"August", AUGUST},
-        {"September", SEPTEMBER},
-        {"October", OCTOBER},
-        {"November", NOVEMBER},
-        {"December", DECEMBER}
-    };
-
-    std::string timeStrCopy = timeStr; // Convert the char array to a string for processing
-
-    // Apply day and month replacements
-    //applyTimeStrReplacements(timeStrCopy, mappings);
-
-    size_t pos;
-    for (const auto& mapping : mappings) {
-        pos = timeStrCopy.find(mapping.first);
-        while (pos != std::string::npos) {
-            timeStrCopy.replace(pos, mapping.first.length(), mapping.second);
-            pos = timeStrCopy.find(mapping.first, pos + mapping.second.length());
+/**
+ * @brief Translates the day and month names in a formatted time
+ * @note Single pass over the text with the tables built by buildLocalizationMaps(), so a translation never gets translated again
+ *
+ * @param timeStr Time formatted by strftime
+ * @return Localized time
+ */
+std::string localizeTimeStr(const char* timeStr) {
+    if (timeStrReplacements.empty())
+        return timeStr;
+
+    std::string localized;
+    bool replaced;
+    for (const char* pos = timeStr; *pos != '\0';) {
+        replaced = false;
+        for (const auto& [english, translated] : timeStrReplacements) {
+            if (std::strncmp(pos, english.c_str(), english.size()) == 0) {
+                localized += translated;
+                pos += english.size();
+                replaced = true;
+                break;
+            }
         }
+        if (!replaced)
+            localized += *pos++;
     }
 
-    // Copy the modified string back to the character array
-    strcpy(timeStr, timeStrCopy.c_str());
+    return localized;
 }
 
 // Unified function to apply replacements
 static void applyLangReplacements(std::string& text, bool isValue = false) {
-    // Define the maps for replacements
-    std::unordered_map<std::string, std::string> replacements;
-
-    if (!isValue) {
-        replacements = {
-            {"Reboot To", REBOOT_TO},
-            {"Boot Entry", BOOT_ENTRY},
-            {"Reboot", REBOOT},
-            {"Shutdown", SHUTDOWN}
-        };
-    } else {
-        replacements = {
-            {"On", ON},
-            {"Off", OFF}
-        };
-    }
+    // Built once per language, empty while the English defaults are active
+    const std::unordered_map<std::string, std::string>& replacements = isValue ? langValueReplacements : langTextReplacements;
 
     // Perform the direct replacement
     auto it = replacements.find(text);
@@ -1116,51 +1130,308 @@ inline float calculateAmplitude(float x, float peakDurationFactor = 0.25f) {
 
 
 static std::atomic<bool> refreshWallpaper(false);
-static std::vector<u8> wallpaperData;
 static std::atomic<bool> inPlot(false);
 
+// Wallpaper held as packed RGBA4444 (2 bytes per pixel) in framebuffer (block-linear) order.
+// The padding rows below the last 720th row are dropped, so it takes exactly width * height * 2 bytes.
+static std::vector<u16> wallpaperData;
+static bool wallpaperOpaque = false;
+static u8 wallpaperBakedAlpha = 0xF; // Layer alpha currently baked into an opaque wallpaperData
+
+// Compact on-disk wallpaper: header followed by RLE packets over the packed RGBA4444 pixels.
+// A "<wallpaper>.rgba4" cache is written next to every loaded ".rgba" file.
+static const std::string PACKED_WALLPAPER_EXT = ".rgba4";
+static constexpr char PACKED_WALLPAPER_MAGIC[4] = {'U', 'W', 'P', '4'};
+
+struct PackedWallpaperHeader {
+    char magic[4];
+    u16 width;
+    u16 height;
+    u64 sourceTime; // Modification time of the .rgba it was converted from (0 if standalone)
+};
+
 std::mutex wallpaperMutex;
 std::condition_variable cv;
 
 
+/**
+ * @brief Decodes a x and y coordinate into a offset into the 448 pixel wide block-linear framebuffer
+ *
+ * @param x X pos
+ * @param y Y Pos
+ * @return Offset in pixels
+ */
+inline u32 getBlockLinearOffset(const s32 x, const s32 y) {
+    return (((y & 127) / 16) + ((x / 32) * 8) + ((y / 128) * 112))*512 +
+            ((y % 16) / 8) * 256 +
+            ((x % 32) / 16) * 128 +
+            ((y % 8) / 2) * 32 +
+            ((x % 16) / 8) * 16 +
+            (y % 2) * 8 +
+            (x % 8);
+}
 
-// Function to load the RGBA file into memory and modify wallpaperData directly
-void loadWallpaperFile(const std::string& filePath, s32 width = 448, s32 height = 720) {
-    // Calculate the size of the bitmap in bytes
-    size_t dataSize = width * height * 4; // 4 bytes per pixel (RGBA8888)
-    
-    // Resize the wallpaperData vector to the required size
-    wallpaperData.resize(dataSize);
-    
-    if (!isFileOrDirectory(filePath)) {
-        wallpaperData.clear(); // Clear wallpaperData if loading failed
+/**
+ * @brief Calls func(framebufferOffset, wallpaperOffset, count) for every contiguous span of the packed wallpaper
+ * @note Whole 128 row blocks are one span, the partial last block is one span per 32 pixel tile column
+ *
+ * @param func Callback
+ * @param height Wallpaper height
+ */
+template<typename Func>
+inline void forEachWallpaperSpan(Func&& func, const s32 height = 720) {
+    const u32 fullBlockPixels = (height / 128) * 448 * 128;
+    if (fullBlockPixels > 0)
+        func(0, 0, fullBlockPixels);
+
+    const u32 tileRows = ((height % 128) + 15) / 16;
+    if (tileRows == 0)
         return;
+
+    for (u32 column = 0; column < 448 / 32; ++column) {
+        func(fullBlockPixels + column * 8 * 512, fullBlockPixels + column * tileRows * 512, tileRows * 512);
+    }
+}
+
+/**
+ * @brief Offset of a pixel inside the packed wallpaper
+ *
+ * @param x X pos
+ * @param y Y pos
+ * @param height Wallpaper height
+ * @return Offset in pixels
+ */
+inline u32 getPackedWallpaperOffset(const s32 x, const s32 y, const s32 height = 720) {
+    const u32 offset = getBlockLinearOffset(x, y);
+    const u32 fullBlockPixels = (height / 128) * 448 * 128;
+    if (offset < fullBlockPixels)
+        return offset;
+
+    const u32 tileRows = ((height % 128) + 15) / 16;
+    const u32 tile = (offset - fullBlockPixels) / 512;
+    return fullBlockPixels + ((tile / 8) * tileRows + (tile % 8)) * 512 + (offset % 512);
+}
+
+/**
+ * @brief Gets the modification time of a file
+ *
+ * @param filePath File path
+ * @return Modification time, 0 if unavailable
+ */
+inline u64 getFileModificationTime(const std::string& filePath) {
+    struct stat fileStat;
+    if (stat(filePath.c_str(), &fileStat) != 0)
+        return 0;
+    return static_cast<u64>(fileStat.st_mtime);
+}
+
+/**
+ * @brief Reads a raw RGBA8888 wallpaper straight into packed wallpaperData
+ *
+ * @param filePath Path of the .rgba file
+ * @return Whether the file was read completely
+ */
+bool readRawWallpaperFile(const std::string& filePath, const s32 width, const s32 height) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    // Stream a few rows at a time instead of holding the whole 8 bit image
+    static constexpr s32 rowsPerRead = 16;
+    std::vector<u8> rowBuffer(width * rowsPerRead * 4);
+    const u8* pixel;
+    s32 rows;
+
+    for (s32 y = 0; y < height; y += rowsPerRead) {
+        rows = std::min(rowsPerRead, height - y);
+        if (!file.read(reinterpret_cast<char*>(rowBuffer.data()), width * rows * 4))
+            return false;
+
+        for (s32 row = 0; row < rows; ++row) {
+            for (s32 x = 0; x < width; ++x) {
+                pixel = &rowBuffer[(row * width + x) * 4];
+                wallpaperData[getPackedWallpaperOffset(x, y + row, height)] = (pixel[0] >> 4) | ((pixel[1] >> 4) << 4) | ((pixel[2] >> 4) << 8) | ((pixel[3] >> 4) << 12);
+            }
+        }
     }
+    return true;
+}
 
-    // Open the file in binary mode
+/**
+ * @brief Reads a packed RLE wallpaper into wallpaperData
+ *
+ * @param filePath Path of the .rgba4 file
+ * @param sourceTime Expected source modification time, 0 to accept any
+ * @return Whether the file was valid and read completely
+ */
+bool readPackedWallpaperFile(const std::string& filePath, const s32 width, const s32 height, const u64 sourceTime = 0) {
     std::ifstream file(filePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    PackedWallpaperHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, PACKED_WALLPAPER_MAGIC, sizeof(header.magic)) != 0 ||
+        header.width != width || header.height != height ||
+        (sourceTime != 0 && header.sourceTime != sourceTime))
+        return false;
+
+    std::streambuf* stream = file.rdbuf();
+    const size_t pixelCount = wallpaperData.size();
+    size_t pos = 0, count;
+    int control, low, high;
+
+    while (pos < pixelCount) {
+        if ((control = stream->sbumpc()) == EOF)
+            return false;
+
+        if (control & 0x80) {
+            // Run of (control & 0x7F) + 2 identical pixels
+            count = (control & 0x7F) + 2;
+            low = stream->sbumpc();
+            high = stream->sbumpc();
+            if (high == EOF || pos + count > pixelCount)
+                return false;
+            std::fill_n(wallpaperData.begin() + pos, count, static_cast<u16>(low | (high << 8)));
+            pos += count;
+        } else {
+            // control + 1 literal pixels
+            count = control + 1;
+            if (pos + count > pixelCount ||
+                stream->sgetn(reinterpret_cast<char*>(&wallpaperData[pos]), count * sizeof(u16)) != static_cast<std::streamsize>(count * sizeof(u16)))
+                return false;
+            pos += count;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Writes wallpaperData as a packed RLE wallpaper
+ *
+ * @param filePath Path of the .rgba4 file
+ * @param sourceTime Modification time of the source .rgba
+ * @return Compressed size in bytes, 0 on failure
+ */
+size_t writePackedWallpaperFile(const std::string& filePath, const s32 width, const s32 height, const u64 sourceTime) {
+    PackedWallpaperHeader header;
+    std::memcpy(header.magic, PACKED_WALLPAPER_MAGIC, sizeof(header.magic));
+    header.width = width;
+    header.height = height;
+    header.sourceTime = sourceTime;
+
+    std::vector<u8> packets;
+    packets.reserve(wallpaperData.size() * sizeof(u16) / 2);
+
+    const size_t pixelCount = wallpaperData.size();
+    size_t pos = 0, run, literalStart;
+
+    while (pos < pixelCount) {
+        run = 1;
+        while (pos + run < pixelCount && run < 129 && wallpaperData[pos + run] == wallpaperData[pos])
+            ++run;
+
+        if (run >= 2) {
+            packets.push_back(0x80 | (run - 2));
+            packets.push_back(wallpaperData[pos] & 0xFF);
+            packets.push_back(wallpaperData[pos] >> 8);
+            pos += run;
+            continue;
+        }
+
+        // Collect literals until the next run starts
+        literalStart = pos;
+        while (pos < pixelCount && pos - literalStart < 128 && !(pos + 1 < pixelCount && wallpaperData[pos + 1] == wallpaperData[pos]))
+            ++pos;
+
+        packets.push_back(pos - literalStart - 1);
+        for (size_t i = literalStart; i < pos; ++i) {
+            packets.push_back(wallpaperData[i] & 0xFF);
+            packets.push_back(wallpaperData[i] >> 8);
+        }
+    }
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return 0;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(packets.data()), packets.size());
     if (!file) {
-        //std::cerr << "Failed to open file: " << filePath << std::endl;
-        wallpaperData.clear(); // Clear wallpaperData if loading failed
+        file.close();
+        deleteFileOrDirectory(filePath);
+        return 0;
+    }
+    return sizeof(header) + packets.size();
+}
+
+
+// Function to load the wallpaper file (.rgba or .rgba4) into wallpaperData
+void loadWallpaperFile(const std::string& filePath, s32 width = 448, s32 height = 720) {
+    wallpaperData.clear();
+
+    if (!isFileOrDirectory(filePath))
         return;
+
+    const auto loadStart = std::chrono::steady_clock::now();
+
+    // Packed RGBA4444, 2 bytes per pixel
+    wallpaperData.resize(width * height);
+
+    const bool isPacked = filePath.size() > PACKED_WALLPAPER_EXT.size() &&
+        filePath.compare(filePath.size() - PACKED_WALLPAPER_EXT.size(), PACKED_WALLPAPER_EXT.size(), PACKED_WALLPAPER_EXT) == 0;
+
+    std::string loadedPath = filePath;
+    size_t packedSize = 0;
+    bool loaded;
+
+    if (isPacked) {
+        loaded = readPackedWallpaperFile(filePath, width, height);
+    } else {
+        // Prefer the packed cache as long as it was converted from this exact file
+        const std::string cachePath = filePath + "4";
+        const u64 sourceTime = getFileModificationTime(filePath);
+
+        loaded = sourceTime != 0 && isFileOrDirectory(cachePath) && readPackedWallpaperFile(cachePath, width, height, sourceTime);
+        if (loaded) {
+            loadedPath = cachePath;
+        } else {
+            loaded = readRawWallpaperFile(filePath, width, height);
+            if (loaded && sourceTime != 0)
+                packedSize = writePackedWallpaperFile(cachePath, width, height, sourceTime);
+        }
     }
-    
-    // Read the file content into the wallpaperData buffer
-    file.read(reinterpret_cast<char*>(wallpaperData.data()), dataSize);
-    if (!file) {
-        //std::cerr << "Failed to read file: " << filePath << std::endl;
-        wallpaperData.clear(); // Clear wallpaperData if reading failed
+
+    if (!loaded) {
+        wallpaperData.clear(); // Clear wallpaperData if loading failed
         return;
     }
-    
-    // Preprocess the bitmap data by shifting the color values
-    for (size_t i = 0; i < dataSize; i += 4) {
-        // Shift the color values to reduce precision (if needed)
-        wallpaperData[i] >>= 4;   // Red
-        wallpaperData[i + 1] >>= 4; // Green
-        wallpaperData[i + 2] >>= 4; // Blue
-        wallpaperData[i + 3] >>= 4; // Alpha
+
+    // An opaque wallpaper fully replaces the background, so apply the blend weight of a full alpha
+    // ((c * 0xF) >> 4) and the layer alpha up front. Drawing it is then a plain copy.
+    wallpaperOpaque = std::all_of(wallpaperData.begin(), wallpaperData.end(), [](const u16 px) { return (px >> 12) == 0xF; });
+    if (wallpaperOpaque) {
+        for (u16& px : wallpaperData) {
+            px = (((px & 0xF) * 0xF) >> 4) |
+                 (((((px >> 4) & 0xF) * 0xF) >> 4) << 4) |
+                 (((((px >> 8) & 0xF) * 0xF) >> 4) << 8) |
+                 0xF000;
+        }
+        wallpaperBakedAlpha = 0xF;
     }
+
+    #if USING_LOGGING_DIRECTIVE
+    const auto loadTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loadStart).count();
+    struct stat loadedStat;
+    const long long fileSize = (stat(loadedPath.c_str(), &loadedStat) == 0) ? static_cast<long long>(loadedStat.st_size) : -1;
+    logMessage("Wallpaper: loaded " + loadedPath + " (" + std::to_string(fileSize) + " bytes on disk) in " + std::to_string(loadTime) +
+        " ms, " + std::to_string(wallpaperData.size() * sizeof(u16)) + " bytes in memory" +
+        (packedSize ? ", wrote " + std::to_string(packedSize) + " byte packed cache" : ""));
+    #else
+    (void)loadStart;
+    (void)loadedPath;
+    (void)packedSize;
+    #endif
 }
 
 
@@ -1606,18 +1877,27 @@ void reinitializeVersionLabels() {
 
 
 
-// Number of renderer threads to use
+// Number of renderer threads to use (0 = rasterize on the calling thread)
 const unsigned numThreads = expandedMemory ? 4 : 0;
-std::vector<std::thread> threads(numThreads);
-s32 bmpChunkSize = (720 + numThreads - 1) / numThreads;
+
+// Record frames on the main thread and rasterize them on a dedicated render thread
+const bool useRenderThread = numThreads > 0;
+s32 bmpChunkSize = numThreads ? (720 + numThreads - 1) / numThreads : 720;
 std::atomic<s32> currentRow;
 
-#include <barrier>
+// Heap budget of the glyph atlas, in bytes
+size_t glyphAtlasBudget = expandedMemory ? 1024 * 1024 : 256 * 1024;
+
+// Number of strings whose layout is kept by the text run cache
+size_t textRunCacheCapacity = expandedMemory ? 512 : 128;
 
-// Assuming numThreads is the number of threads you have
-std::barrier inPlotBarrier(numThreads, [](){
-    inPlot.store(false, std::memory_order_release);
-});
+// Number of layer framebuffers. A third one (~630 KB) lets rendering run a frame ahead of the display
+const u32 framebufferCount = expandedMemory ? 3 : 2;
+
+// Headless builds (-DUSING_HEADLESS_DIRECTIVE=1) render into memory instead of a vi layer, see Renderer::init
+#ifndef USING_HEADLESS_DIRECTIVE
+#define USING_HEADLESS_DIRECTIVE 0
+#endif
 
 
 
@@ -1973,6 +2253,7 @@ namespace tsl {
         // Set Ultrahand Globals
         useSwipeToOpen = (parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "swipe_to_open") == TRUE_STR);
         useOpaqueScreenshots = (parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "opaque_screenshots") == TRUE_STR);
+        useFrameProfiler = (parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "frame_profiler") == TRUE_STR);
     }
 
     
@@ -2059,6 +2340,19 @@ namespace tsl {
     
     namespace hlp {
         
+        /**
+         * @brief Monotonic time used for frame timing and the frame profiler
+         *
+         * @return Time in nanoseconds
+         */
+        static inline u64 getTimeNs() {
+        #if USING_HEADLESS_DIRECTIVE
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        #else
+            return armTicksToNs(armGetSystemTick());
+        #endif
+        }
+        
         /**
          * @brief Wrapper for service initialization
          *
@@ -2118,6 +2412,7 @@ namespace tsl {
             return serviceDispatchIn(hidsysGetServiceSession(), 503, in);
         }
         
+        #if !USING_HEADLESS_DIRECTIVE
         static Result viAddToLayerStack(ViLayer *layer, ViLayerStack stack) {
             const struct {
                 u32 stack;
@@ -2126,6 +2421,7 @@ namespace tsl {
             
             return serviceDispatchIn(viGetSession_IManagerDisplayService(), 6000, in);
         }
+        #endif
         
         /**
          * @brief Toggles focus between the Tesla overlay and the rest of the system
@@ -2403,79 +2699,1801 @@ namespace tsl {
         struct ScissoringConfig {
             s32 x, y, w, h;
         };
-        
+
+        #if USING_HEADLESS_DIRECTIVE
         /**
-         * @brief Manages the Tesla layer and draws raw data to the screen
+         * @brief Writes RGBA8888 pixels as an uncompressed PNG
+         * @note Uses stored deflate blocks, so it needs no zlib. Meant for frame dumps of the headless backend
+         *
+         * @param path Destination file
+         * @param width Image width
+         * @param height Image height
+         * @param rgba Pixels, 4 bytes each, rows top to bottom
+         * @return true on success
          */
-        class Renderer final {
-        public:
+        inline bool writePNG(const std::string& path, const u32 width, const u32 height, const u8* rgba) {
+            static u32 crcTable[256] = {};
+            if (crcTable[1] == 0) {
+                for (u32 n = 0; n < 256; ++n) {
+                    u32 c = n;
+                    for (u8 k = 0; k < 8; ++k)
+                        c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+                    crcTable[n] = c;
+                }
+            }
+
+            std::vector<u8> out;
+            const auto putU32 = [&out](const u32 value) {
+                out.push_back(value >> 24); out.push_back(value >> 16); out.push_back(value >> 8); out.push_back(value);
+            };
+            const auto putChunk = [&out, &putU32](const char* type, const std::vector<u8>& data) {
+                putU32(static_cast<u32>(data.size()));
+                const size_t start = out.size();
+                out.insert(out.end(), type, type + 4);
+                out.insert(out.end(), data.begin(), data.end());
+                u32 crc = 0xFFFFFFFFU;
+                for (size_t i = start; i < out.size(); ++i)
+                    crc = crcTable[(crc ^ out[i]) & 0xFF] ^ (crc >> 8);
+                putU32(crc ^ 0xFFFFFFFFU);
+            };
+
+            static const u8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            out.insert(out.end(), signature, signature + 8);
+
+            std::vector<u8> header = { u8(width >> 24), u8(width >> 16), u8(width >> 8), u8(width),
+                                       u8(height >> 24), u8(height >> 16), u8(height >> 8), u8(height),
+                                       8, 6, 0, 0, 0 };   // 8 bit RGBA, no interlacing
+            putChunk("IHDR", header);
+
+            // Filter byte 0 per row, then the row
+            std::vector<u8> raw;
+            raw.reserve((width * 4 + 1) * height);
+            for (u32 y = 0; y < height; ++y) {
+                raw.push_back(0);
+                raw.insert(raw.end(), rgba + y * width * 4, rgba + (y + 1) * width * 4);
+            }
+
+            std::vector<u8> zlib = { 0x78, 0x01 };
+            u32 adlerA = 1, adlerB = 0;
+            for (size_t pos = 0; pos < raw.size(); ) {
+                const u16 length = static_cast<u16>(std::min<size_t>(raw.size() - pos, 0xFFFF));
+                zlib.push_back(pos + length == raw.size());
+                zlib.push_back(length); zlib.push_back(length >> 8);
+                zlib.push_back(~length); zlib.push_back(~length >> 8);
+                zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + length);
+                pos += length;
+            }
+            for (const u8 byte : raw) {
+                adlerA = (adlerA + byte) % 65521;
+                adlerB = (adlerB + adlerA) % 65521;
+            }
+            const u32 adler = (adlerB << 16) | adlerA;
+            zlib.push_back(adler >> 24); zlib.push_back(adler >> 16); zlib.push_back(adler >> 8); zlib.push_back(adler);
+            putChunk("IDAT", zlib);
+            putChunk("IEND", {});
+
+            FILE* file = fopen(path.c_str(), "wb");
+            if (file == nullptr)
+                return false;
+            const bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+            fclose(file);
+            return written;
+        }
+        #endif
+
+        /**
+         * @brief Screen region in half-open pixel bounds, used for damage tracking and clipping
+         */
+        struct DamageRect {
+            s32 x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+            inline bool empty() const {
+                return this->x0 >= this->x1 || this->y0 >= this->y1;
+            }
+
+            inline bool intersects(const s32 x, const s32 y, const s32 w, const s32 h) const {
+                return x < this->x1 && y < this->y1 && x + w > this->x0 && y + h > this->y0;
+            }
 
-            Renderer& operator=(Renderer&) = delete;
-            
-            friend class tsl::Overlay;
-            
             /**
-             * @brief Handles opacity of drawn colors for fadeout. Pass all colors through this function in order to apply opacity properly
+             * @brief Grows the rect to the bounding box of itself and another rect
              *
-             * @param c Original color
-             * @return Color with applied opacity
+             * @param other Rect to merge in
              */
-            inline static Color a(const Color& c) {
-                u8 alpha = (disableTransparency && useOpaqueScreenshots) ? 0xF : static_cast<u8>(std::min(static_cast<u8>(c.a), static_cast<u8>(0xF * Renderer::s_opacity)));
-                return (c.rgba & 0x0FFF) | (alpha << 12);
+            inline void merge(const DamageRect& other) {
+                if (other.empty())
+                    return;
+
+                if (this->empty()) {
+                    *this = other;
+                    return;
+                }
+
+                this->x0 = std::min(this->x0, other.x0);
+                this->y0 = std::min(this->y0, other.y0);
+                this->x1 = std::max(this->x1, other.x1);
+                this->y1 = std::max(this->y1, other.y1);
             }
-            
+
             /**
-             * @brief Enables scissoring, discarding of any draw outside the given boundaries
+             * @brief Shrinks the rect to its overlap with another rect
              *
-             * @param x x pos
-             * @param y y pos
-             * @param w Width
-             * @param h Height
+             * @param other Rect to intersect with
              */
-            inline void enableScissoring(const s32 x, const s32 y, const s32 w, const s32 h) {
-                this->m_scissoringStack.emplace(x, y, w, h);
+            inline void intersect(const DamageRect& other) {
+                this->x0 = std::max(this->x0, other.x0);
+                this->y0 = std::max(this->y0, other.y0);
+                this->x1 = std::min(this->x1, other.x1);
+                this->y1 = std::min(this->y1, other.y1);
             }
-            
-            /**
-             * @brief Disables scissoring
-             */
-            inline void disableScissoring() {
-                this->m_scissoringStack.pop();
+        };
+
+        // RGBA4444 source-over blend kernels
+        //
+        // Every kernel writes dst = (src * src.a + dst * (0xF - src.a)) >> 4 per color channel and keeps the
+        // destination alpha, matching Renderer::setPixelBlendSrc. The table kernel instead matches
+        // Renderer::setPixelBlendDst for uniform fills. dst must point to contiguous pixels, which in the
+        // block-linear framebuffer means one aligned run of 8 columns or a span from Renderer::forEachSpan.
+        // Byte sources only use the low nibble of every byte, like a Color built from them, so larger values
+        // can't spill into the neighbouring channels.
+
+        /**
+         * @brief Scalar reference for \ref blendRGBA4444
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param src Source pixels, one byte per 4 bit channel (RGBA order)
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444Scalar(u16* dst, const u8* src, const size_t count) {
+            u16 d;
+            u8 alpha, inverse;
+            for (size_t i = 0; i < count; ++i, src += 4) {
+                d = dst[i];
+                alpha = src[3] & 0xF;
+                inverse = 0xF - alpha;
+                dst[i] = (((src[0] & 0xF) * alpha + (d & 0xF) * inverse) >> 4) |
+                         ((((src[1] & 0xF) * alpha + ((d >> 4) & 0xF) * inverse) >> 4) << 4) |
+                         ((((src[2] & 0xF) * alpha + ((d >> 8) & 0xF) * inverse) >> 4) << 8) |
+                         (d & 0xF000);
             }
-            
-            
-            // Drawing functions
-            
+        }
+
+        /**
+         * @brief Scalar reference for \ref blendRGBA4444Packed
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param src Source RGBA4444 pixels
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444PackedScalar(u16* dst, const u16* src, const size_t count) {
+            u16 d, s;
+            u8 alpha, inverse;
+            for (size_t i = 0; i < count; ++i) {
+                d = dst[i];
+                s = src[i];
+                alpha = s >> 12;
+                inverse = 0xF - alpha;
+                dst[i] = (((s & 0xF) * alpha + (d & 0xF) * inverse) >> 4) |
+                         (((((s >> 4) & 0xF) * alpha + ((d >> 4) & 0xF) * inverse) >> 4) << 4) |
+                         (((((s >> 8) & 0xF) * alpha + ((d >> 8) & 0xF) * inverse) >> 4) << 8) |
+                         (d & 0xF000);
+            }
+        }
+
+    #if defined(__ARM_NEON)
+        /**
+         * @brief Blends 8 unpacked source pixels onto 8 RGBA4444 pixels
+         * @note Every source channel has to be at most 0xF
+         */
+        ALWAYS_INLINE uint16x8_t blendRGBA4444x8(const uint16x8_t dst, const uint8x8_t r, const uint8x8_t g, const uint8x8_t b, const uint8x8_t alpha) {
+            const uint16x8_t nibble = vdupq_n_u16(0xF);
+            const uint8x8_t inverse = vsub_u8(vdup_n_u8(0xF), alpha);
+
+            const uint8x8_t dstR = vmovn_u16(vandq_u16(dst, nibble));
+            const uint8x8_t dstG = vmovn_u16(vandq_u16(vshrq_n_u16(dst, 4), nibble));
+            const uint8x8_t dstB = vmovn_u16(vandq_u16(vshrq_n_u16(dst, 8), nibble));
+
+            // At most 0xF * 0xF, so every channel stays within its nibble after the shift
+            const uint16x8_t outR = vshrq_n_u16(vmlal_u8(vmull_u8(r, alpha), dstR, inverse), 4);
+            const uint16x8_t outG = vshrq_n_u16(vmlal_u8(vmull_u8(g, alpha), dstG, inverse), 4);
+            const uint16x8_t outB = vshrq_n_u16(vmlal_u8(vmull_u8(b, alpha), dstB, inverse), 4);
+
+            uint16x8_t out = vandq_u16(dst, vdupq_n_u16(0xF000));
+            out = vorrq_u16(out, outR);
+            out = vorrq_u16(out, vshlq_n_u16(outG, 4));
+            out = vorrq_u16(out, vshlq_n_u16(outB, 8));
+            return out;
+        }
+    #endif
+
+        /**
+         * @brief Source-over blends one byte per channel RGBA pixels onto RGBA4444 pixels
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param src Source pixels, one byte per 4 bit channel (RGBA order)
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444(u16* dst, const u8* src, size_t count) {
+        #if defined(__ARM_NEON)
+            const uint8x8_t nibble = vdup_n_u8(0xF);
+            for (; count >= 8; count -= 8, dst += 8, src += 32) {
+                const uint8x8x4_t pixels = vld4_u8(src);
+                vst1q_u16(dst, blendRGBA4444x8(vld1q_u16(dst), vand_u8(pixels.val[0], nibble), vand_u8(pixels.val[1], nibble),
+                    vand_u8(pixels.val[2], nibble), vand_u8(pixels.val[3], nibble)));
+            }
+        #endif
+            blendRGBA4444Scalar(dst, src, count);
+        }
+
+        /**
+         * @brief Source-over blends RGBA4444 pixels onto RGBA4444 pixels
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param src Source RGBA4444 pixels
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444Packed(u16* dst, const u16* src, size_t count) {
+        #if defined(__ARM_NEON)
+            const uint16x8_t nibble = vdupq_n_u16(0xF);
+            uint16x8_t pixels;
+            for (; count >= 8; count -= 8, dst += 8, src += 8) {
+                pixels = vld1q_u16(src);
+                vst1q_u16(dst, blendRGBA4444x8(vld1q_u16(dst),
+                    vmovn_u16(vandq_u16(pixels, nibble)),
+                    vmovn_u16(vandq_u16(vshrq_n_u16(pixels, 4), nibble)),
+                    vmovn_u16(vandq_u16(vshrq_n_u16(pixels, 8), nibble)),
+                    vmovn_u16(vshrq_n_u16(pixels, 12))));
+            }
+        #endif
+            blendRGBA4444PackedScalar(dst, src, count);
+        }
+
+        /**
+         * @brief Per-nibble lookup tables for blending one fixed color onto RGBA4444 pixels
+         * @note Every resulting channel only depends on the matching destination channel, so a uniform fill
+         *       collapses into four 16 entry lookups. Green and alpha are stored pre-shifted into the high nibble.
+         */
+        struct RGBA4444BlendTable {
+            alignas(16) u8 red[16];
+            alignas(16) u8 green[16];
+            alignas(16) u8 blue[16];
+            alignas(16) u8 alpha[16];
+
+            RGBA4444BlendTable() = default;
+
             /**
-             * @brief Draw a single pixel onto the screen
+             * @brief Builds the tables for a fill color, matching Renderer::setPixelBlendDst
              *
-             * @param x X pos
-             * @param y Y pos
-             * @param color Color
+             * @param r Red
+             * @param g Green
+             * @param b Blue
+             * @param a Alpha
              */
-            inline void setPixel(const s32 x, const s32 y, const Color& color, const u32 offset) {
-                if (x < cfg::FramebufferWidth && y < cfg::FramebufferHeight) {
-                    //u32 offset = this->getPixelOffset(x, y);
-                    if (offset != UINT32_MAX) {
-                        Color* framebuffer = static_cast<Color*>(this->getCurrentFramebuffer());
-                        framebuffer[offset] = color;
-                    }
+            inline RGBA4444BlendTable(const u8 r, const u8 g, const u8 b, const u8 a) {
+                const u8 inverse = 0xF - a;
+                for (u8 d = 0; d < 16; ++d) {
+                    this->red[d]   = (r * a + d * inverse) >> 4;
+                    this->green[d] = ((g * a + d * inverse) >> 4) << 4;
+                    this->blue[d]  = (b * a + d * inverse) >> 4;
+                    this->alpha[d] = (a + d * inverse / 0xF) << 4;
                 }
             }
+        };
 
+        /**
+         * @brief Scalar reference for \ref blendRGBA4444Table
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param table Blend tables of the fill color
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444TableScalar(u16* dst, const RGBA4444BlendTable& table, const size_t count) {
+            u16 d;
+            for (size_t i = 0; i < count; ++i) {
+                d = dst[i];
+                dst[i] = (table.red[d & 0xF] | table.green[(d >> 4) & 0xF]) |
+                         ((table.blue[(d >> 8) & 0xF] | table.alpha[d >> 12]) << 8);
+            }
+        }
 
-            
-            /**
-             * @brief Blends two colors
-             *
-             * @param src Source color
-             * @param dst Destination color
-             * @param alpha Opacity
-             * @return Blended color
-             */
-            inline u8 blendColor(const u8 src, const u8 dst, const u8 alpha) {
-                return (dst * alpha + src * (0x0F - alpha)) >> 4;
+        /**
+         * @brief Blends one fixed color onto RGBA4444 pixels, accumulating the destination alpha
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param table Blend tables of the fill color
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444Table(u16* dst, const RGBA4444BlendTable& table, size_t count) {
+        #if defined(__ARM_NEON)
+            const uint8x16_t red = vld1q_u8(table.red), green = vld1q_u8(table.green);
+            const uint8x16_t blue = vld1q_u8(table.blue), alpha = vld1q_u8(table.alpha);
+            const uint8x8_t nibble = vdup_n_u8(0xF);
+            uint8x8x2_t pixels;
+            for (; count >= 8; count -= 8, dst += 8) {
+                // val[0] holds green|red, val[1] alpha|blue of every pixel
+                pixels = vld2_u8(reinterpret_cast<const u8*>(dst));
+                pixels.val[0] = vorr_u8(vqtbl1_u8(red, vand_u8(pixels.val[0], nibble)), vqtbl1_u8(green, vshr_n_u8(pixels.val[0], 4)));
+                pixels.val[1] = vorr_u8(vqtbl1_u8(blue, vand_u8(pixels.val[1], nibble)), vqtbl1_u8(alpha, vshr_n_u8(pixels.val[1], 4)));
+                vst2_u8(reinterpret_cast<u8*>(dst), pixels);
+            }
+        #endif
+            blendRGBA4444TableScalar(dst, table, count);
+        }
+
+        /**
+         * @brief Scalar reference for \ref blendRGBA4444Coverage
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param coverage Glyph coverage per pixel, 0x0 to 0xF
+         * @param color Text color
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444CoverageScalar(u16* dst, const u8* coverage, const Color& color, const size_t count) {
+            u16 d;
+            u8 alpha, inverse;
+            for (size_t i = 0; i < count; ++i) {
+                alpha = coverage[i];
+                if (alpha == 0x0)
+                    continue;
+                if (alpha == 0xF) {
+                    dst[i] = color.rgba;
+                    continue;
+                }
+
+                d = dst[i];
+                inverse = 0xF - alpha;
+                dst[i] = ((color.r * alpha + (d & 0xF) * inverse) >> 4) |
+                         (((color.g * alpha + ((d >> 4) & 0xF) * inverse) >> 4) << 4) |
+                         (((color.b * alpha + ((d >> 8) & 0xF) * inverse) >> 4) << 8) |
+                         ((alpha + (d >> 12) * inverse / 0xF) << 12);
+            }
+        }
+
+        /**
+         * @brief Draws glyph coverage in a text color onto RGBA4444 pixels
+         * @note Full coverage writes the color as is, partial coverage destination blends it with the coverage as
+         *       alpha and zero coverage leaves the pixel alone, matching Renderer::setPixelBlendDst per pixel
+         *
+         * @param dst Destination RGBA4444 pixels
+         * @param coverage Glyph coverage per pixel, 0x0 to 0xF
+         * @param color Text color
+         * @param count Number of pixels
+         */
+        inline void blendRGBA4444Coverage(u16* dst, const u8* coverage, const Color& color, size_t count) {
+        #if defined(__ARM_NEON)
+            const uint16x8_t nibble = vdupq_n_u16(0xF);
+            const uint16x8_t full = vdupq_n_u16(color.rgba);
+            const uint8x8_t r = vdup_n_u8(color.r), g = vdup_n_u8(color.g), b = vdup_n_u8(color.b);
+            uint16x8_t d, alpha16, out;
+            uint8x8_t alpha, inverse;
+            for (; count >= 8; count -= 8, dst += 8, coverage += 8) {
+                alpha = vld1_u8(coverage);
+                inverse = vsub_u8(vdup_n_u8(0xF), alpha);
+                d = vld1q_u16(dst);
+
+                out = vshrq_n_u16(vmlal_u8(vmull_u8(r, alpha), vmovn_u16(vandq_u16(d, nibble)), inverse), 4);
+                out = vorrq_u16(out, vshlq_n_u16(vshrq_n_u16(vmlal_u8(vmull_u8(g, alpha), vmovn_u16(vandq_u16(vshrq_n_u16(d, 4), nibble)), inverse), 4), 4));
+                out = vorrq_u16(out, vshlq_n_u16(vshrq_n_u16(vmlal_u8(vmull_u8(b, alpha), vmovn_u16(vandq_u16(vshrq_n_u16(d, 8), nibble)), inverse), 4), 8));
+
+                // dst.a * inverse / 15, exact as (x * 137) >> 11 for every x up to 15 * 15
+                alpha16 = vmovl_u8(alpha);
+                out = vorrq_u16(out, vshlq_n_u16(vaddq_u16(alpha16, vshrq_n_u16(vmulq_n_u16(vmull_u8(vmovn_u16(vshrq_n_u16(d, 12)), inverse), 137), 11)), 12));
+
+                out = vbslq_u16(vceqq_u16(alpha16, nibble), full, out);
+                out = vbslq_u16(vceqq_u16(alpha16, vdupq_n_u16(0)), d, out);
+                vst1q_u16(dst, out);
+            }
+        #endif
+            blendRGBA4444CoverageScalar(dst, coverage, color, count);
+        }
+
+        /**
+         * @brief Persistent pool of raster workers
+         * @note Workers are spawned once and sleep between jobs. Rows are handed out through the lock-free
+         *       \ref currentRow cursor, and the submitting thread pulls rows as well until the job is drained.
+         */
+        class RasterWorkerPool {
+        public:
+            RasterWorkerPool() = default;
+            RasterWorkerPool(const RasterWorkerPool&) = delete;
+            RasterWorkerPool& operator=(const RasterWorkerPool&) = delete;
+
+            ~RasterWorkerPool() {
+                this->stop();
+            }
+
+            /**
+             * @brief Spawns the worker threads
+             *
+             * @param count Number of workers. 0 keeps all rasterization on the calling thread
+             */
+            inline void start(const unsigned count) {
+                if (!this->m_workers.empty())
+                    return;
+
+                this->m_stopping = false;
+                this->m_workers.reserve(count);
+                for (unsigned i = 0; i < count; ++i) {
+                    this->m_workers.emplace_back(&RasterWorkerPool::workerLoop, this);
+                }
+            }
+
+            /**
+             * @brief Wakes all workers, lets them exit and joins them
+             */
+            inline void stop() {
+                if (this->m_workers.empty())
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> lock(this->m_mutex);
+                    this->m_stopping = true;
+                }
+                this->m_wakeCv.notify_all();
+
+                for (auto& worker : this->m_workers) {
+                    if (worker.joinable())
+                        worker.join();
+                }
+                this->m_workers.clear();
+            }
+
+            /**
+             * @brief Runs a row job across the pool and blocks until every row has been processed
+             *
+             * @param startRow First row (inclusive)
+             * @param endRow Last row (exclusive)
+             * @param rowsPerJob Number of rows handed out per fetch
+             * @param job Callable taking (startRow, endRow)
+             */
+            template<typename Job>
+            inline void run(const s32 startRow, const s32 endRow, const s32 rowsPerJob, Job&& job) {
+                if (startRow >= endRow)
+                    return;
+
+                // Sequential fallback
+                if (this->m_workers.empty()) {
+                    job(startRow, endRow);
+                    return;
+                }
+
+                this->m_context = static_cast<void*>(&job);
+                this->m_invoke = [](void* context, const s32 rowStart, const s32 rowEnd) {
+                    (*static_cast<std::remove_reference_t<Job>*>(context))(rowStart, rowEnd);
+                };
+                this->m_endRow = endRow;
+                this->m_rowsPerJob = std::max(rowsPerJob, 1);
+                currentRow.store(startRow, std::memory_order_relaxed);
+                this->m_busyWorkers.store(static_cast<u32>(this->m_workers.size()), std::memory_order_relaxed);
+
+                {
+                    std::lock_guard<std::mutex> lock(this->m_mutex);
+                    ++this->m_generation;
+                }
+                this->m_wakeCv.notify_all();
+
+                // Help out instead of idling
+                this->drain();
+
+                std::unique_lock<std::mutex> lock(this->m_mutex);
+                this->m_doneCv.wait(lock, [this] { return this->m_busyWorkers.load(std::memory_order_acquire) == 0; });
+            }
+
+        private:
+            std::vector<std::thread> m_workers;
+            std::mutex m_mutex;
+            std::condition_variable m_wakeCv, m_doneCv;
+            u32 m_generation = 0;
+            bool m_stopping = false;
+
+            std::atomic<u32> m_busyWorkers = 0;
+            void (*m_invoke)(void*, s32, s32) = nullptr;
+            void* m_context = nullptr;
+            s32 m_endRow = 0;
+            s32 m_rowsPerJob = 1;
+
+            inline void drain() {
+                s32 row;
+                while ((row = currentRow.fetch_add(this->m_rowsPerJob, std::memory_order_relaxed)) < this->m_endRow) {
+                    this->m_invoke(this->m_context, row, std::min(row + this->m_rowsPerJob, this->m_endRow));
+                }
+            }
+
+            static void workerLoop(RasterWorkerPool* self) {
+                u32 seenGeneration = 0;
+
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(self->m_mutex);
+                        self->m_wakeCv.wait(lock, [self, seenGeneration] { return self->m_stopping || self->m_generation != seenGeneration; });
+                        if (self->m_stopping)
+                            return;
+                        seenGeneration = self->m_generation;
+                    }
+
+                    self->drain();
+
+                    if (self->m_busyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        std::lock_guard<std::mutex> lock(self->m_mutex);
+                        self->m_doneCv.notify_one();
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Rasterized glyph and its metrics
+         * @note Only the upper 4 bits of the rasterized coverage are ever used, so it is stored as nibbles,
+         *       two pixels per byte with the even column in the low nibble
+         */
+        struct Glyph {
+            stbtt_fontinfo *currFont;
+            float currFontSize;
+            int bounds[4];
+            int xAdvance;
+            int width, height;
+            std::vector<u8> coverage;
+
+            /**
+             * @brief Bytes per coverage row
+             */
+            inline s32 getStride() const {
+                return (this->width + 1) / 2;
+            }
+
+            /**
+             * @brief Gets the 4 bit coverage of a glyph pixel
+             *
+             * @param x X pos inside the glyph
+             * @param y Y pos inside the glyph
+             * @return Coverage from 0x0 to 0xF
+             */
+            inline u8 getCoverage(const s32 x, const s32 y) const {
+                return (this->coverage[y * this->getStride() + x / 2] >> ((x & 1) * 4)) & 0xF;
+            }
+
+            /**
+             * @brief Packs an 8 bit stb_truetype bitmap of width * height bytes into \ref coverage
+             *
+             * @param bitmap Rasterized glyph
+             */
+            inline void packCoverage(const u8* bitmap) {
+                const s32 stride = this->getStride();
+                this->coverage.assign(stride * this->height, 0);
+
+                u8* row;
+                for (s32 y = 0; y < this->height; ++y, bitmap += this->width) {
+                    row = this->coverage.data() + y * stride;
+                    for (s32 x = 0; x < this->width; ++x) {
+                        row[x / 2] |= (bitmap[x] >> 4) << ((x & 1) * 4);
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Glyph masks and pen positions of a short string, laid out once and redrawn with a color per glyph
+         * @note Owns copies of its glyphs, so it stays valid while the atlas evicts them. The glyphs are shared and never
+         *       modified, a new layout replaces them while frames recorded earlier keep the old ones alive
+         */
+        struct GlyphRun {
+            std::string text;
+            s32 fontSize = 0;
+            std::shared_ptr<const std::vector<Glyph>> glyphs;
+            std::vector<float> penX;
+            float endX = 0;             // Pen position after the last glyph
+        };
+
+        /**
+         * @brief Byte bounded glyph cache with least recently used eviction
+         * @note Pointers returned by \ref find and \ref insert stay valid until that glyph gets evicted,
+         *       which never happens to the most recently used one.
+         */
+        class GlyphAtlas {
+        public:
+            struct Stats {
+                u64 hits = 0, misses = 0, evictions = 0;
+                size_t bytes = 0, glyphs = 0;
+            };
+
+            GlyphAtlas() = default;
+            GlyphAtlas(const GlyphAtlas&) = delete;
+            GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+            /**
+             * @brief Sets the byte budget, evicting glyphs right away if the atlas is over it
+             *
+             * @param bytes Budget in bytes
+             */
+            inline void setBudget(const size_t bytes) {
+                this->m_budget = bytes;
+                this->evict();
+            }
+
+            /**
+             * @brief Looks up a glyph and marks it as most recently used
+             *
+             * @param key Glyph key
+             * @return Glyph or nullptr on a miss
+             */
+            inline Glyph* find(const u64 key) {
+                const auto it = this->m_index.find(key);
+                if (it == this->m_index.end()) {
+                    ++this->m_stats.misses;
+                    return nullptr;
+                }
+
+                ++this->m_stats.hits;
+                this->m_entries.splice(this->m_entries.begin(), this->m_entries, it->second);
+                return &it->second->second;
+            }
+
+            /**
+             * @brief Checks if a glyph is cached, without touching its age or the counters
+             *
+             * @param key Glyph key
+             * @return true if cached
+             */
+            inline bool contains(const u64 key) const {
+                return this->m_index.contains(key);
+            }
+
+            /**
+             * @brief Adds a glyph as most recently used and evicts the oldest ones until the atlas fits its budget
+             *
+             * @param key Glyph key
+             * @param glyph Rasterized glyph
+             * @return The cached glyph
+             */
+            inline Glyph* insert(const u64 key, Glyph&& glyph) {
+                if (const auto it = this->m_index.find(key); it != this->m_index.end())
+                    this->erase(it->second);
+
+                this->m_entries.emplace_front(key, std::move(glyph));
+                this->m_index.emplace(key, this->m_entries.begin());
+                this->m_stats.bytes += getEntrySize(this->m_entries.front().second);
+                this->m_stats.glyphs = this->m_entries.size();
+
+                this->evict();
+                return &this->m_entries.front().second;
+            }
+
+            /**
+             * @brief Drops every cached glyph, the counters are kept
+             */
+            inline void clear() {
+                this->m_index.clear();
+                this->m_entries.clear();
+                this->m_stats.bytes = 0;
+                this->m_stats.glyphs = 0;
+            }
+
+            inline const Stats& getStats() const {
+                return this->m_stats;
+            }
+
+        private:
+            using Entry = std::pair<u64, Glyph>;
+
+            std::list<Entry> m_entries;     // Most recently used first
+            std::unordered_map<u64, std::list<Entry>::iterator> m_index;
+            size_t m_budget = 0;
+            Stats m_stats;
+
+            /**
+             * @brief Heap footprint of a cached glyph including its bookkeeping
+             */
+            inline static size_t getEntrySize(const Glyph& glyph) {
+                return sizeof(Entry) + 2 * sizeof(void*) + sizeof(std::pair<u64, std::list<Entry>::iterator>) + glyph.coverage.capacity();
+            }
+
+            inline void erase(const std::list<Entry>::iterator entry) {
+                this->m_stats.bytes -= getEntrySize(entry->second);
+                this->m_index.erase(entry->first);
+                this->m_entries.erase(entry);
+                this->m_stats.glyphs = this->m_entries.size();
+            }
+
+            inline void evict() {
+                while (this->m_stats.bytes > this->m_budget && this->m_entries.size() > 1) {
+                    this->erase(std::prev(this->m_entries.end()));
+                    ++this->m_stats.evictions;
+                }
+            }
+        };
+
+        /**
+         * @brief Decoded string and its measurements, shared by drawString, calculateStringWidth and limitStringLength
+         * @note Measurements are filled in by the first call that needs them
+         */
+        struct TextRun {
+            std::string text;
+            s32 fontSize = 0;
+            bool monospace = false;
+
+            std::vector<u32> codepoints;        // Decoded up to the first invalid sequence
+            std::vector<u32> byteEnds;          // Byte offset right after each codepoint
+            std::vector<float> prefixWidths;    // calculateStringWidth of every prefix, prefixWidths[0] is the empty one
+
+            bool drawMeasured = false;          // drawString extent without a width limit
+            u32 drawWidth = 0, drawHeight = 0;
+
+            s32 truncatedMaxLength = -1;        // Last limitStringLength query and its cut, npos if it fit
+            size_t truncatedBytes = std::string::npos;
+        };
+
+        /**
+         * @brief Fixed capacity cache of text runs with least recently used eviction
+         * @note A returned run stays valid until the next \ref get call
+         */
+        class TextRunCache {
+        public:
+            TextRunCache() = default;
+            TextRunCache(const TextRunCache&) = delete;
+            TextRunCache& operator=(const TextRunCache&) = delete;
+
+            /**
+             * @brief Sets the maximum number of cached runs
+             *
+             * @param capacity Number of runs
+             */
+            inline void setCapacity(const size_t capacity) {
+                this->m_capacity = std::max<size_t>(capacity, 1);
+                while (this->m_runs.size() > this->m_capacity) {
+                    this->erase(std::prev(this->m_runs.end()));
+                }
+            }
+
+            /**
+             * @brief Gets the run of a string, decoding it on a miss
+             *
+             * @param text String
+             * @param fontSize Height of the text in pixels
+             * @param monospace Monospace / fixed width numbers flag of the caller
+             * @return Cached run
+             */
+            inline TextRun& get(const std::string& text, const s32 fontSize, const bool monospace) {
+                const u64 key = getKey(text, fontSize, monospace);
+
+                if (const auto it = this->m_index.find(key); it != this->m_index.end()) {
+                    TextRun& run = *it->second;
+                    if (run.fontSize == fontSize && run.monospace == monospace && run.text == text) {
+                        this->m_runs.splice(this->m_runs.begin(), this->m_runs, it->second);
+                        return run;
+                    }
+
+                    // Hash collision, the newer string takes over the slot
+                    this->erase(it->second);
+                }
+
+                if (this->m_runs.size() >= this->m_capacity)
+                    this->erase(std::prev(this->m_runs.end()));
+
+                TextRun& run = this->m_runs.emplace_front();
+                run.text = text;
+                run.fontSize = fontSize;
+                run.monospace = monospace;
+
+                u32 codepoint;
+                ssize_t codepointWidth;
+                for (size_t pos = 0; pos < text.size(); pos += codepointWidth) {
+                    codepointWidth = decode_utf8(&codepoint, reinterpret_cast<const u8*>(text.data() + pos));
+                    if (codepointWidth <= 0)
+                        break;
+
+                    run.codepoints.push_back(codepoint);
+                    run.byteEnds.push_back(pos + codepointWidth);
+                }
+
+                this->m_index.emplace(key, this->m_runs.begin());
+                return run;
+            }
+
+            inline void clear() {
+                this->m_index.clear();
+                this->m_runs.clear();
+            }
+
+        private:
+            std::list<TextRun> m_runs;      // Most recently used first
+            std::unordered_map<u64, std::list<TextRun>::iterator> m_index;
+            size_t m_capacity = 1;
+
+            inline static u64 getKey(const std::string& text, const s32 fontSize, const bool monospace) {
+                return std::hash<std::string_view>{}(text) ^ ((static_cast<u64>(fontSize) << 1 | monospace) * 0x9E3779B97F4A7C15ULL);
+            }
+
+            inline void erase(const std::list<TextRun>::iterator run) {
+                this->m_index.erase(getKey(run->text, run->fontSize, run->monospace));
+                this->m_runs.erase(run);
+            }
+        };
+
+        /**
+         * @brief Font resolution, advance and kerning tables for string measurement
+         * @note Resolution and unscaled advances do not depend on the font size, so they are kept per codepoint in
+         *       lazily allocated 256 codepoint pages of the BMP. Scales are kept per font size and kerning per pair.
+         */
+        class FontMetrics {
+        public:
+            enum FontIndex : u8 {
+                FontStandard = 0,
+                FontLocal = 1,
+                FontExtended = 2
+            };
+
+            struct CodepointMetrics {
+                u8 font;
+                s16 xAdvance;       // Unscaled advance width
+                float widthFactor;  // characterWidths override relative to the font size, negative if there is none
+            };
+
+            FontMetrics() = default;
+            FontMetrics(const FontMetrics&) = delete;
+            FontMetrics& operator=(const FontMetrics&) = delete;
+
+            /**
+             * @brief Binds the fonts and drops every table built for the previous ones
+             */
+            inline void setFonts(stbtt_fontinfo* stdFont, stbtt_fontinfo* localFont, stbtt_fontinfo* extFont, const bool hasLocalFont) {
+                this->m_fonts[FontStandard] = stdFont;
+                this->m_fonts[FontLocal] = localFont;
+                this->m_fonts[FontExtended] = extFont;
+                this->m_hasLocalFont = hasLocalFont;
+                this->clear();
+            }
+
+            /**
+             * @brief Drops every table, they get rebuilt on demand
+             */
+            inline void clear() {
+                for (auto& page : this->m_pages) {
+                    page.reset();
+                }
+                this->m_scales.clear();
+                this->m_kerning.clear();
+            }
+
+            inline stbtt_fontinfo* getFont(const u8 font) const {
+                return this->m_fonts[font];
+            }
+
+            /**
+             * @brief Picks the font a codepoint is drawn with
+             * @note Does not touch any table, so it is safe to call from any thread
+             *
+             * @param codepoint Unicode codepoint
+             * @return Font index
+             */
+            inline u8 resolveFont(const u32 codepoint) const {
+                if (stbtt_FindGlyphIndex(this->m_fonts[FontExtended], codepoint))
+                    return FontExtended;
+                if (this->m_hasLocalFont && stbtt_FindGlyphIndex(this->m_fonts[FontStandard], codepoint) == 0)
+                    return FontLocal;
+                return FontStandard;
+            }
+
+            /**
+             * @brief Gets the font, advance and width override of a codepoint
+             *
+             * @param codepoint Unicode codepoint
+             * @return Metrics
+             */
+            inline CodepointMetrics get(const u32 codepoint) {
+                if (codepoint > 0xFFFF)
+                    return this->resolve(codepoint);
+
+                auto& page = this->m_pages[codepoint >> 8];
+                if (!page) {
+                    page = std::make_unique<Page>();
+                    std::fill(std::begin(page->font), std::end(page->font), Unresolved);
+                }
+
+                const u32 index = codepoint & 0xFF;
+                if (page->font[index] == Unresolved) {
+                    const CodepointMetrics metrics = this->resolve(codepoint);
+                    page->font[index] = metrics.font;
+                    page->xAdvance[index] = metrics.xAdvance;
+                    page->widthFactor[index] = metrics.widthFactor;
+                    return metrics;
+                }
+
+                return { page->font[index], page->xAdvance[index], page->widthFactor[index] };
+            }
+
+            /**
+             * @brief Gets the scale of a font for a pixel height
+             *
+             * @param font Font index
+             * @param fontSize Height of the text in pixels
+             * @return stbtt_ScaleForPixelHeight of that font
+             */
+            inline float getScale(const u8 font, const s32 fontSize) {
+                for (const auto& scale : this->m_scales) {
+                    if (scale.fontSize == fontSize)
+                        return scale.scale[font];
+                }
+
+                auto& scale = this->m_scales.emplace_back();
+                scale.fontSize = fontSize;
+                for (u8 i = 0; i < 3; ++i) {
+                    scale.scale[i] = (i != FontLocal || this->m_hasLocalFont) ? stbtt_ScaleForPixelHeight(this->m_fonts[i], fontSize) : 0.0F;
+                }
+                return scale.scale[font];
+            }
+
+            /**
+             * @brief Gets the unscaled kerning between two codepoints
+             *
+             * @param font Font index of the second codepoint
+             * @param prevCodepoint First codepoint
+             * @param codepoint Second codepoint
+             * @return Kerning advance
+             */
+            inline s32 getKernAdvance(const u8 font, const u32 prevCodepoint, const u32 codepoint) {
+                const u64 key = (static_cast<u64>(font) << 42) | (static_cast<u64>(prevCodepoint & 0x1FFFFF) << 21) | (codepoint & 0x1FFFFF);
+                if (const auto it = this->m_kerning.find(key); it != this->m_kerning.end())
+                    return it->second;
+
+                if (this->m_kerning.size() >= MaxKerningPairs)
+                    this->m_kerning.clear();
+
+                const s16 kernAdvance = stbtt_GetCodepointKernAdvance(this->m_fonts[font], prevCodepoint, codepoint);
+                this->m_kerning.emplace(key, kernAdvance);
+                return kernAdvance;
+            }
+
+        private:
+            static constexpr u8 Unresolved = 0xFF;
+            static constexpr size_t MaxKerningPairs = 4096;
+
+            struct Page {
+                u8 font[256];
+                s16 xAdvance[256];
+                float widthFactor[256];
+            };
+
+            struct SizeScale {
+                s32 fontSize;
+                float scale[3];
+            };
+
+            stbtt_fontinfo* m_fonts[3] = {};
+            bool m_hasLocalFont = false;
+            std::unique_ptr<Page> m_pages[256];
+            std::vector<SizeScale> m_scales;
+            std::unordered_map<u64, s16> m_kerning;
+
+            inline CodepointMetrics resolve(const u32 codepoint) const {
+                CodepointMetrics metrics;
+                metrics.font = this->resolveFont(codepoint);
+
+                int xAdvance = 0, leftBearing = 0;
+                stbtt_GetCodepointHMetrics(this->m_fonts[metrics.font], codepoint, &xAdvance, &leftBearing);
+                metrics.xAdvance = static_cast<s16>(xAdvance);
+
+                const auto it = characterWidths.find(static_cast<wchar_t>(codepoint));
+                metrics.widthFactor = (it != characterWidths.end()) ? it->second : -1.0F;
+                return metrics;
+            }
+        };
+
+        /**
+         * @brief Recorded draw calls of one frame
+         * @note Built on the thread running the element tree's draw() and executed later by the render thread.
+         *       Commands hold plain values and indices into the list's own string table. Bitmap, glyph and region
+         *       commands point at memory owned by their callers, which has to stay valid until the frame got executed.
+         *       A serialized list carries copies of that memory, so it replays elsewhere without its callers
+         */
+        class DisplayList {
+        public:
+            enum class CommandType : u8 {
+                LatchDamage,
+                Rect,
+                RoundedRect,
+                Circle,
+                QuarterCircle,
+                String,
+                Bitmap,
+                Wallpaper,
+                FillScreen,
+                ClearScreen,
+                PushScissor,
+                PopScissor,
+                ReadRegion,
+                WriteRegion,
+                GlyphMask
+            };
+
+            struct Command {
+                CommandType type;
+                u8 flags = 0;               // Filled and quadrant for circles, monospace for strings
+                u16 color = 0;
+                s32 x = 0, y = 0, w = 0, h = 0;
+                s32 param = 0;              // Radius or font size
+                u32 index = 0;              // String table index
+                const void* data = nullptr; // Bitmap pixels, region pixels or glyph, see hasPayload()
+            };
+
+            DamageRect damage;              // Repaint region of the frame, valid once latched
+            bool damageLatched = false;
+            u32 damageSerial = 0;           // Damage counter at the time the damage got latched, not serialized
+
+            /**
+             * @brief Empties the list for a new frame
+             */
+            inline void reset() {
+                this->m_commands.clear();
+                this->m_strings.clear();
+                this->m_retained.clear();
+                this->damage = {};
+                this->damageLatched = false;
+                this->damageSerial = 0;
+            }
+
+            /**
+             * @brief Appends a command
+             *
+             * @param command Command
+             */
+            inline void add(const Command& command) {
+                this->m_commands.push_back(command);
+            }
+
+            /**
+             * @brief Appends a string command
+             *
+             * @param text Text, already resolved (e.g. the throbber)
+             * @param monospace Draw in monospace font
+             * @param x X pos
+             * @param y Y pos
+             * @param fontSize Font size
+             * @param color Color
+             * @param maxWidth Max width, 0 for none
+             */
+            inline void addString(const std::string& text, const bool monospace, const s32 x, const s32 y, const s32 fontSize, const Color& color, const s32 maxWidth) {
+                this->m_strings.push_back(text);
+                this->add({ .type = CommandType::String, .flags = monospace, .color = color.rgba, .x = x, .y = y, .w = maxWidth,
+                            .param = fontSize, .index = static_cast<u32>(this->m_strings.size() - 1) });
+            }
+
+            /**
+             * @brief Keeps memory a command points at alive until the list gets reset for another frame
+             *
+             * @param data Shared data
+             */
+            inline void retain(std::shared_ptr<const void> data) {
+                this->m_retained.push_back(std::move(data));
+            }
+
+            inline const std::vector<Command>& getCommands() const {
+                return this->m_commands;
+            }
+
+            inline const std::string& getString(const u32 index) const {
+                return this->m_strings[index];
+            }
+
+            /**
+             * @brief Checks if a command type points at memory through \ref Command::data
+             *
+             * @param type Command type
+             * @return true for bitmap, region and glyph commands
+             */
+            inline static bool hasPayload(const CommandType type) {
+                return type == CommandType::Bitmap || type == CommandType::ReadRegion || type == CommandType::WriteRegion || type == CommandType::GlyphMask;
+            }
+
+            /**
+             * @brief Writes the list into a byte buffer
+             * @note Little endian host layout. The memory behind data pointers gets copied into a payload table,
+             *       commands pointing at the same memory share one payload, so a region read earlier in the frame
+             *       gets written back from the same buffer. The wallpaper is not part of a list, a replay draws
+             *       whatever wallpaper is loaded
+             *
+             * @param out Destination, gets overwritten
+             */
+            inline void serialize(std::vector<u8>& out) const {
+                out.clear();
+                const auto put = [&out](const auto& value) {
+                    const u8* bytes = reinterpret_cast<const u8*>(&value);
+                    out.insert(out.end(), bytes, bytes + sizeof(value));
+                };
+                const auto putBytes = [&out](const void* data, const size_t size) {
+                    const u8* bytes = static_cast<const u8*>(data);
+                    out.insert(out.end(), bytes, bytes + size);
+                };
+
+                // One payload per distinct pointer, sized for the largest command using it
+                struct Payload {
+                    const void* data;
+                    CommandType type;
+                    size_t size;
+                };
+                std::vector<Payload> payloads;
+                std::unordered_map<const void*, u32> payloadIndex;
+                size_t size;
+                for (const Command& command : this->m_commands) {
+                    if (!DisplayList::hasPayload(command.type) || command.data == nullptr)
+                        continue;
+
+                    size = static_cast<size_t>(command.w) * command.h * ((command.type == CommandType::Bitmap) ? 4 : sizeof(u16));
+                    const auto [it, inserted] = payloadIndex.try_emplace(command.data, static_cast<u32>(payloads.size()));
+                    if (inserted)
+                        payloads.push_back({ command.data, command.type == CommandType::ReadRegion ? CommandType::WriteRegion : command.type, size });
+                    else
+                        payloads[it->second].size = std::max(payloads[it->second].size, size);
+                }
+
+                put(DisplayList::SerialMagic);
+                put(this->damage);
+                put(static_cast<u8>(this->damageLatched));
+                put(static_cast<u32>(this->m_commands.size()));
+                for (const Command& command : this->m_commands) {
+                    put(command.type);
+                    put(command.flags);
+                    put(command.color);
+                    put(command.x);
+                    put(command.y);
+                    put(command.w);
+                    put(command.h);
+                    put(command.param);
+                    put((DisplayList::hasPayload(command.type) && command.data != nullptr) ? payloadIndex[command.data] : command.index);
+                    put(static_cast<u8>(command.data != nullptr));
+                }
+
+                put(static_cast<u32>(this->m_strings.size()));
+                for (const std::string& string : this->m_strings) {
+                    put(static_cast<u32>(string.size()));
+                    out.insert(out.end(), string.begin(), string.end());
+                }
+
+                put(static_cast<u32>(payloads.size()));
+                for (const Payload& payload : payloads) {
+                    put(payload.type);
+                    if (payload.type == CommandType::GlyphMask) {
+                        const Glyph& glyph = *static_cast<const Glyph*>(payload.data);
+                        put(static_cast<s32>(glyph.width));
+                        put(static_cast<s32>(glyph.height));
+                        put(glyph.bounds);
+                        put(static_cast<u32>(glyph.coverage.size()));
+                        putBytes(glyph.coverage.data(), glyph.coverage.size());
+                    } else {
+                        put(static_cast<u32>(payload.size));
+                        putBytes(payload.data, payload.size);
+                    }
+                }
+            }
+
+            /**
+             * @brief Reads a list written by \ref serialize
+             *
+             * @param in Serialized list
+             * @return false if the data is truncated or not a display list, the list is left empty then
+             */
+            inline bool deserialize(const std::vector<u8>& in) {
+                this->reset();
+                size_t pos = 0;
+                const auto get = [&in, &pos](auto& value) {
+                    if (pos + sizeof(value) > in.size())
+                        return false;
+                    std::memcpy(&value, in.data() + pos, sizeof(value));
+                    pos += sizeof(value);
+                    return true;
+                };
+
+                u32 magic = 0, count = 0, length = 0;
+                u8 latched = 0;
+                if (!get(magic) || magic != DisplayList::SerialMagic || !get(this->damage) || !get(latched) || !get(count))
+                    return this->fail();
+                this->damageLatched = latched != 0;
+
+                Command command;
+                u8 hasData = 0;
+                std::vector<bool> dataCommands;
+                for (u32 i = 0; i < count; ++i) {
+                    command = {};
+                    if (!get(command.type) || !get(command.flags) || !get(command.color) || !get(command.x) || !get(command.y) ||
+                        !get(command.w) || !get(command.h) || !get(command.param) || !get(command.index) || !get(hasData))
+                        return this->fail();
+                    this->m_commands.push_back(command);
+                    dataCommands.push_back(hasData != 0);
+                }
+
+                if (!get(count))
+                    return this->fail();
+                for (u32 i = 0; i < count; ++i) {
+                    if (!get(length) || pos + length > in.size())
+                        return this->fail();
+                    this->m_strings.emplace_back(reinterpret_cast<const char*>(in.data() + pos), length);
+                    pos += length;
+                }
+
+                // Payloads are owned by the list from here on
+                struct Payload {
+                    CommandType type;
+                    const void* data;
+                    size_t size;
+                };
+                std::vector<Payload> payloads;
+                CommandType type;
+                if (!get(count))
+                    return this->fail();
+                for (u32 i = 0; i < count; ++i) {
+                    if (!get(type))
+                        return this->fail();
+
+                    if (type == CommandType::GlyphMask) {
+                        auto glyph = std::make_shared<Glyph>();
+                        glyph->currFont = nullptr;
+                        s32 width = 0, height = 0;
+                        if (!get(width) || !get(height) || !get(glyph->bounds) || !get(length) || pos + length > in.size() ||
+                            width < 0 || height < 0 || length < static_cast<u32>((width + 1) / 2 * height))
+                            return this->fail();
+                        glyph->width = width;
+                        glyph->height = height;
+                        glyph->coverage.assign(in.begin() + pos, in.begin() + pos + length);
+                        pos += length;
+                        payloads.push_back({ type, glyph.get(), 0 });
+                        this->retain(std::move(glyph));
+                    } else {
+                        if (!get(length) || pos + length > in.size())
+                            return this->fail();
+                        auto bytes = std::make_shared<std::vector<u8>>(in.begin() + pos, in.begin() + pos + length);
+                        pos += length;
+                        payloads.push_back({ type, bytes->data(), bytes->size() });
+                        this->retain(std::move(bytes));
+                    }
+                }
+
+                for (size_t i = 0; i < this->m_commands.size(); ++i) {
+                    Command& parsed = this->m_commands[i];
+                    if (parsed.type == CommandType::String && parsed.index >= this->m_strings.size())
+                        return this->fail();
+                    if (!DisplayList::hasPayload(parsed.type) || !dataCommands[i])
+                        continue;
+
+                    // The payload has to be of the command's kind and large enough for it
+                    if (parsed.index >= payloads.size() || parsed.w < 0 || parsed.h < 0)
+                        return this->fail();
+                    const Payload& payload = payloads[parsed.index];
+                    const CommandType kind = (parsed.type == CommandType::ReadRegion) ? CommandType::WriteRegion : parsed.type;
+                    const size_t needed = static_cast<size_t>(parsed.w) * parsed.h * ((parsed.type == CommandType::Bitmap) ? 4 : sizeof(u16));
+                    if (payload.type != kind || (kind != CommandType::GlyphMask && payload.size < needed))
+                        return this->fail();
+                    parsed.data = payload.data;
+                    parsed.index = 0;
+                }
+                return true;
+            }
+
+        private:
+            static constexpr u32 SerialMagic = 0x324C4454; // "TDL2"
+
+            std::vector<Command> m_commands;
+            std::vector<std::string> m_strings;
+            std::vector<std::shared_ptr<const void>> m_retained;
+
+            inline bool fail() {
+                this->reset();
+                return false;
+            }
+        };
+
+        /**
+         * @brief Frame pacing counters of a triple buffered layer
+         */
+        struct RenderAheadStats {
+            u64 frames = 0;             // Frames rendered ahead of the display
+            u64 framesOverBudget = 0;   // Frames that took longer than a vsync period
+            u64 framesSaved = 0;        // Frames over budget absorbed by the spare framebuffer instead of dropped
+        };
+
+        /**
+         * @brief Optional timing of every frame's stages and of the draw calls of every element class
+         * @note Enabled by the frame_profiler setting. While disabled every hook costs one branch on useFrameProfiler.
+         *       The last \ref WindowSize frames feed rolling percentiles for the HUD, all samples get appended to
+         *       \ref CsvPath by a writer thread, so the SD card is never touched by the frame being profiled. The file
+         *       gets truncated whenever profiling is switched on. Raster and EndFrame run on the render thread and get
+         *       committed with the next frame.
+         */
+        class FrameProfiler {
+        public:
+            enum class Stage : u8 {
+                Update,     // Gui::update and damage polling
+                Draw,       // Element tree draw, records the display list when the render thread runs
+                Raster,     // Display list execution on the render thread
+                EndFrame,   // Vsync wait and present
+                Count
+            };
+
+            // Rolling statistics in microseconds
+            struct Percentiles {
+                u32 p50 = 0, p95 = 0, max = 0;
+            };
+
+            static constexpr u32 WindowSize = 120;
+            static inline const std::string CsvPath = SETTINGS_PATH + "frame_profile.csv";
+
+            /**
+             * @brief Adds time spent in a stage to the current frame
+             *
+             * @param stage Stage
+             * @param ns Time in nanoseconds
+             */
+            inline static void addStage(const Stage stage, const u64 ns) {
+                std::lock_guard<std::mutex> lock(FrameProfiler::s_mutex);
+                FrameProfiler::s_stageNs[static_cast<size_t>(stage)] += ns;
+            }
+
+            /**
+             * @brief Starts timing an element's frame, see \ref endElement
+             * @note Main thread only, elements nest
+             *
+             * @return Start time to pass to \ref endElement
+             */
+            inline static u64 beginElement() {
+                FrameProfiler::s_childNs.push_back(0);
+                return hlp::getTimeNs();
+            }
+
+            /**
+             * @brief Stops timing an element's frame and books the time not spent in its children to its class
+             *
+             * @param className Class name of the element, a string literal
+             * @param startNs Time returned by \ref beginElement
+             */
+            inline static void endElement(const char* className, const u64 startNs) {
+                if (FrameProfiler::s_childNs.empty())
+                    return;
+
+                const u64 elapsedNs = hlp::getTimeNs() - startNs;
+                const u64 childNs = FrameProfiler::s_childNs.back();
+                FrameProfiler::s_childNs.pop_back();
+                if (!FrameProfiler::s_childNs.empty())
+                    FrameProfiler::s_childNs.back() += elapsedNs;
+
+                ElementClass& element = FrameProfiler::getElementClass(className);
+                element.frameNs += elapsedNs - std::min(elapsedNs, childNs);
+            }
+
+            /**
+             * @brief Closes the current frame: feeds the rolling windows and queues its CSV rows
+             * @note Called by the main thread once per drawn frame
+             */
+            static void commitFrame() {
+                u64 stageNs[static_cast<size_t>(Stage::Count)];
+                {
+                    std::lock_guard<std::mutex> lock(FrameProfiler::s_mutex);
+                    std::copy(std::begin(FrameProfiler::s_stageNs), std::end(FrameProfiler::s_stageNs), stageNs);
+                    std::fill(std::begin(FrameProfiler::s_stageNs), std::end(FrameProfiler::s_stageNs), 0);
+                }
+
+                static const char* const stageNames[] = { "update", "draw", "raster", "end_frame" };
+                const std::string frame = std::to_string(FrameProfiler::s_frame++) + ',';
+                for (size_t i = 0; i < static_cast<size_t>(Stage::Count); ++i) {
+                    FrameProfiler::s_stages[i].push(stageNs[i] / 1000);
+                    FrameProfiler::s_csv += frame + stageNames[i] + ',' + std::to_string(stageNs[i] / 1000) + '\n';
+                }
+                for (ElementClass& element : FrameProfiler::s_elements) {
+                    element.window.push(element.frameNs / 1000);
+                    if (element.frameNs != 0)
+                        FrameProfiler::s_csv += frame + element.name + ',' + std::to_string(element.frameNs / 1000) + '\n';
+                    element.frameNs = 0;
+                }
+                FrameProfiler::s_childNs.clear();
+
+                if (FrameProfiler::s_csv.size() >= CsvFlushSize)
+                    FrameProfiler::queueCsv();
+            }
+
+            /**
+             * @brief Writes out all queued CSV rows and stops the writer thread
+             * @note Blocks until the rows are on the SD card. Called when profiling gets switched off and on exit
+             */
+            static void flush() {
+                FrameProfiler::queueCsv();
+                if (!FrameProfiler::s_writerThread.joinable())
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> lock(FrameProfiler::s_writerMutex);
+                    FrameProfiler::s_writerStopping = true;
+                }
+                FrameProfiler::s_writerCv.notify_all();
+                FrameProfiler::s_writerThread.join();
+            }
+
+            /**
+             * @brief Drops all statistics and starts a new CSV file, e.g. when profiling gets switched on
+             */
+            static void reset() {
+                {
+                    std::lock_guard<std::mutex> lock(FrameProfiler::s_writerMutex);
+                    FrameProfiler::s_truncateCsv = true;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(FrameProfiler::s_mutex);
+                    std::fill(std::begin(FrameProfiler::s_stageNs), std::end(FrameProfiler::s_stageNs), 0);
+                }
+                for (Window& window : FrameProfiler::s_stages)
+                    window = Window();
+                FrameProfiler::s_elements.clear();
+                FrameProfiler::s_childNs.clear();
+                FrameProfiler::s_csv.clear();
+                FrameProfiler::s_frame = 0;
+            }
+
+            inline static Percentiles getStage(const Stage stage) {
+                return FrameProfiler::s_stages[static_cast<size_t>(stage)].get();
+            }
+
+            /**
+             * @brief Gets the element classes that cost the most draw time
+             *
+             * @param count Max number of classes
+             * @return Class names with their rolling statistics, highest 95th percentile first
+             */
+            static std::vector<std::pair<const char*, Percentiles>> getTopElements(const size_t count) {
+                std::vector<std::pair<const char*, Percentiles>> top;
+                for (const ElementClass& element : FrameProfiler::s_elements)
+                    top.emplace_back(element.name, element.window.get());
+
+                std::sort(top.begin(), top.end(), [](const auto& a, const auto& b) { return a.second.p95 > b.second.p95; });
+                if (top.size() > count)
+                    top.resize(count);
+                return top;
+            }
+
+        private:
+            static constexpr size_t CsvFlushSize = 16 * 1024;
+
+            /**
+             * @brief Hands the CSV rows of the last frames to the writer thread, starting it if needed
+             */
+            static void queueCsv() {
+                if (FrameProfiler::s_csv.empty())
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> lock(FrameProfiler::s_writerMutex);
+                    if (FrameProfiler::s_pendingCsv.empty())
+                        FrameProfiler::s_pendingCsv.swap(FrameProfiler::s_csv);
+                    else
+                        FrameProfiler::s_pendingCsv += FrameProfiler::s_csv;
+                    FrameProfiler::s_writerStopping = false;
+                }
+                FrameProfiler::s_csv.clear();
+
+                if (FrameProfiler::s_writerThread.joinable())
+                    FrameProfiler::s_writerCv.notify_all();
+                else
+                    FrameProfiler::s_writerThread = std::thread(&FrameProfiler::writerThreadFunc);
+            }
+
+            /**
+             * @brief Appends queued CSV rows to \ref CsvPath until \ref flush stops it
+             */
+            static void writerThreadFunc() {
+                std::string rows;
+                std::unique_lock<std::mutex> lock(FrameProfiler::s_writerMutex);
+                while (true) {
+                    FrameProfiler::s_writerCv.wait(lock, [] { return !FrameProfiler::s_pendingCsv.empty() || FrameProfiler::s_writerStopping; });
+                    if (FrameProfiler::s_pendingCsv.empty())
+                        return;
+
+                    rows.clear();
+                    rows.swap(FrameProfiler::s_pendingCsv);
+                    const bool truncate = FrameProfiler::s_truncateCsv;
+                    FrameProfiler::s_truncateCsv = false;
+                    lock.unlock();
+
+                    const bool exists = !truncate && isFileOrDirectory(CsvPath);
+                    if (FILE* file = fopen(CsvPath.c_str(), truncate ? "w" : "a")) {
+                        if (!exists)
+                            fputs("frame,name,microseconds\n", file);
+                        fwrite(rows.data(), 1, rows.size(), file);
+                        fclose(file);
+                    }
+
+                    lock.lock();
+                }
+            }
+
+            // No member initializers, the static windows below need Window complete. Value-initialize it instead
+            struct Window {
+                u32 samples[WindowSize];
+                u32 count, next;
+
+                inline void push(const u32 value) {
+                    this->samples[this->next] = value;
+                    this->next = (this->next + 1) % WindowSize;
+                    this->count = std::min(this->count + 1, WindowSize);
+                }
+
+                inline Percentiles get() const {
+                    if (this->count == 0)
+                        return {};
+
+                    u32 sorted[WindowSize];
+                    std::copy(this->samples, this->samples + this->count, sorted);
+                    std::sort(sorted, sorted + this->count);
+                    return { sorted[this->count / 2], sorted[(this->count * 95) / 100], sorted[this->count - 1] };
+                }
+            };
+
+            struct ElementClass {
+                const char* name;
+                u64 frameNs = 0;
+                Window window;
+            };
+
+            inline static ElementClass& getElementClass(const char* className) {
+                for (ElementClass& element : FrameProfiler::s_elements) {
+                    if (element.name == className)
+                        return element;
+                }
+                return FrameProfiler::s_elements.emplace_back(ElementClass{ .name = className, .frameNs = 0, .window = Window() });
+            }
+
+            static inline std::mutex s_mutex;
+            static inline u64 s_stageNs[static_cast<size_t>(Stage::Count)] = {};
+            static inline Window s_stages[static_cast<size_t>(Stage::Count)];
+            static inline std::vector<ElementClass> s_elements;
+            static inline std::vector<u64> s_childNs;
+            static inline std::string s_csv;
+            static inline u64 s_frame = 0;
+
+            // CSV writer, see queueCsv()
+            static inline std::thread s_writerThread;
+            static inline std::mutex s_writerMutex;
+            static inline std::condition_variable s_writerCv;
+            static inline std::string s_pendingCsv;
+            static inline bool s_writerStopping = false;
+            static inline bool s_truncateCsv = false;
+        };
+
+        /**
+         * @brief Manages the Tesla layer and draws raw data to the screen
+         */
+        class Renderer final {
+        public:
+
+            Renderer& operator=(Renderer&) = delete;
+            
+            friend class tsl::Overlay;
+        #if USING_HEADLESS_DIRECTIVE
+            friend class HeadlessHost;  // Host side driver of the headless backend, e.g. the renderer benchmark
+        #endif
+            
+            /**
+             * @brief Handles opacity of drawn colors for fadeout. Pass all colors through this function in order to apply opacity properly
+             *
+             * @param c Original color
+             * @return Color with applied opacity
+             */
+            inline static Color a(const Color& c) {
+                u8 alpha = (disableTransparency && useOpaqueScreenshots) ? 0xF : Renderer::s_opacityAlpha[c.a];
+                return (c.rgba & 0x0FFF) | (alpha << 12);
+            }
+            
+            /**
+             * @brief Enables scissoring, discarding of any draw outside the given boundaries
+             *
+             * @param x x pos
+             * @param y y pos
+             * @param w Width
+             * @param h Height
+             */
+            inline void enableScissoring(const s32 x, const s32 y, const s32 w, const s32 h) {
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::PushScissor, .x = x, .y = y, .w = w, .h = h });
+                    return;
+                }
+
+                this->m_scissoringStack.emplace(x, y, w, h);
+                this->updateClip();
+            }
+
+            /**
+             * @brief Disables scissoring
+             */
+            inline void disableScissoring() {
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::PopScissor });
+                    return;
+                }
+
+                this->m_scissoringStack.pop();
+                this->updateClip();
+            }
+
+            /**
+             * @brief Flags a region to be repainted in every framebuffer
+             * @note Damage reported before the frame's background gets cleared is part of that frame,
+             *       anything reported later is repainted from the next frame on.
+             *
+             * @param x X pos
+             * @param y Y pos
+             * @param w Width
+             * @param h Height
+             */
+            inline static void addDamage(const s32 x, const s32 y, const s32 w, const s32 h) {
+                DamageRect rect = { x, y, x + w, y + h };
+                rect.intersect(Renderer::getLayerRect());
+                if (rect.empty())
+                    return;
+
+                std::lock_guard<std::mutex> lock(Renderer::s_damageMutex);
+                for (auto& slotDamage : Renderer::s_slotDamage)
+                    slotDamage.merge(rect);
+                Renderer::s_damageSerial++;
+                Renderer::s_damagePending = true;
+            }
+
+            /**
+             * @brief Flags the whole layer to be repainted in every framebuffer
+             */
+            inline static void invalidateAll() {
+                Renderer::addDamage(0, 0, cfg::FramebufferWidth, cfg::FramebufferHeight);
+                Renderer::s_layerGeneration++;
+            }
+
+            /**
+             * @brief Gets a counter that changes whenever the whole layer got invalidated
+             * @note Off-screen copies of framebuffer content are stale once this changes (theme, wallpaper, opacity, Gui changes)
+             *
+             * @return Generation
+             */
+            inline static u32 getLayerGeneration() {
+                return Renderer::s_layerGeneration;
+            }
+
+            /**
+             * @brief Checks if a region gets repainted this frame
+             * @note Elements can skip drawing entirely when this returns false, their pixels are still valid
+             *
+             * @param x X pos
+             * @param y Y pos
+             * @param w Width
+             * @param h Height
+             * @return true if the region overlaps the damaged area
+             */
+            inline bool isDamaged(const s32 x, const s32 y, const s32 w, const s32 h) const {
+                if (const DisplayList* list = Renderer::s_recording)
+                    return !list->damageLatched || list->damage.intersects(x, y, w, h);
+
+                return !this->m_damageLatched || this->m_damage.intersects(x, y, w, h);
+            }
+
+            /**
+             * @brief Checks if a region gets repainted completely this frame
+             *
+             * @param x X pos
+             * @param y Y pos
+             * @param w Width
+             * @param h Height
+             * @return true if the damaged area covers the region
+             */
+            inline bool isRepainted(const s32 x, const s32 y, const s32 w, const s32 h) const {
+                const bool latched = Renderer::s_recording ? Renderer::s_recording->damageLatched : this->m_damageLatched;
+                const DamageRect& damage = Renderer::s_recording ? Renderer::s_recording->damage : this->m_damage;
+                return !latched || (damage.x0 <= x && damage.y0 <= y && damage.x1 >= x + w && damage.y1 >= y + h);
+            }
+
+            /**
+             * @brief Copies a region of the current framebuffer into a linear buffer
+             *
+             * @param pixels Destination, one row of w pixels after another
+             * @param x X pos of the region
+             * @param y Y pos of the region
+             * @param w Width of the region
+             * @param h Height of the region
+             */
+            inline void readRegion(u16* pixels, const s32 x, const s32 y, const s32 w, const s32 h) {
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::ReadRegion, .x = x, .y = y, .w = w, .h = h, .data = pixels });
+                    return;
+                }
+
+                const u16* framebuffer = static_cast<const u16*>(this->getCurrentFramebuffer());
+                Renderer::forEachRun({ x, y, x + w, y + h }, [framebuffer, pixels, x, y, w](const s32 runX, const s32 runY, const s32 count) {
+                    std::memcpy(pixels + (runY - y) * w + (runX - x), framebuffer + getBlockLinearOffset(runX, runY), count * sizeof(u16));
+                });
+            }
+
+            /**
+             * @brief Copies a linear buffer back into a region of the current framebuffer
+             * @note Respects damage and scissoring like every other drawing function
+             *
+             * @param pixels Source, one row of w pixels after another
+             * @param x X pos of the region
+             * @param y Y pos of the region
+             * @param w Width of the region
+             * @param h Height of the region
+             */
+            inline void writeRegion(const u16* pixels, const s32 x, const s32 y, const s32 w, const s32 h) {
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::WriteRegion, .x = x, .y = y, .w = w, .h = h, .data = pixels });
+                    return;
+                }
+
+                DamageRect region = { x, y, x + w, y + h };
+                region.intersect(this->m_clip);
+
+                u16* framebuffer = static_cast<u16*>(this->getCurrentFramebuffer());
+                Renderer::forEachRun(region, [framebuffer, pixels, x, y, w](const s32 runX, const s32 runY, const s32 count) {
+                    std::memcpy(framebuffer + getBlockLinearOffset(runX, runY), pixels + (runY - y) * w + (runX - x), count * sizeof(u16));
+                });
+            }
+
+            /**
+             * @brief Copies a region of the current framebuffer into a shared buffer
+             * @note A recording list keeps the buffer alive until the frame got rendered, so its owner may go away at any time
+             *
+             * @param pixels Destination, at least w * h pixels
+             * @param x X pos of the region
+             * @param y Y pos of the region
+             * @param w Width of the region
+             * @param h Height of the region
+             */
+            inline void readRegion(const std::shared_ptr<std::vector<u16>>& pixels, const s32 x, const s32 y, const s32 w, const s32 h) {
+                if (DisplayList* list = Renderer::s_recording)
+                    list->retain(pixels);
+
+                this->readRegion(pixels->data(), x, y, w, h);
+            }
+
+            /**
+             * @brief Copies a shared buffer back into a region of the current framebuffer
+             * @note A recording list keeps the buffer alive until the frame got rendered, see \ref readRegion
+             *
+             * @param pixels Source, at least w * h pixels
+             * @param x X pos of the region
+             * @param y Y pos of the region
+             * @param w Width of the region
+             * @param h Height of the region
+             */
+            inline void writeRegion(const std::shared_ptr<const std::vector<u16>>& pixels, const s32 x, const s32 y, const s32 w, const s32 h) {
+                if (DisplayList* list = Renderer::s_recording)
+                    list->retain(pixels);
+
+                this->writeRegion(pixels->data(), x, y, w, h);
+            }
+
+            
+            // Drawing functions
+            
+            /**
+             * @brief Draw a single pixel onto the screen
+             *
+             * @param x X pos
+             * @param y Y pos
+             * @param color Color
+             */
+            inline void setPixel(const s32 x, const s32 y, const Color& color, const u32 offset) {
+                if (x < cfg::FramebufferWidth && y < cfg::FramebufferHeight) {
+                    //u32 offset = this->getPixelOffset(x, y);
+                    if (offset != UINT32_MAX) {
+                        Color* framebuffer = static_cast<Color*>(this->getCurrentFramebuffer());
+                        framebuffer[offset] = color;
+                    }
+                }
+            }
+
+
+            
+            /**
+             * @brief Blends two colors
+             *
+             * @param src Source color
+             * @param dst Destination color
+             * @param alpha Opacity
+             * @return Blended color
+             */
+            inline u8 blendColor(const u8 src, const u8 dst, const u8 alpha) {
+                return (dst * alpha + src * (0x0F - alpha)) >> 4;
             }
             
             /**
@@ -2520,18 +4538,41 @@ namespace tsl {
                 u32 offset = this->getPixelOffset(x, y);
                 if (offset == UINT32_MAX)
                     return;
-                
-                u16* framebuffer = static_cast<u16*>(this->getCurrentFramebuffer());
-                //src=framebuffer[offset];
+
+                this->blendPixelDst(static_cast<u16*>(this->getCurrentFramebuffer()), offset, color);
+            }
+
+            /**
+             * @brief Destination blends a pixel that is already known to lie inside the clip rect
+             * @note Primitives clip their bounds against \ref m_clip once up front and then write through this
+             *
+             * @param framebuffer Current framebuffer
+             * @param offset Block-linear pixel offset
+             * @param color Color
+             */
+            inline void blendPixelDst(u16* framebuffer, const u32 offset, const Color& color) {
                 Color src(framebuffer[offset]);
-                
+
                 Color end(0);
                 end.r = blendColor(src.r, color.r, color.a);
                 end.g = blendColor(src.g, color.g, color.a);
                 end.b = blendColor(src.b, color.b, color.a);
                 end.a = color.a + (src.a * (0xF - color.a) / 0xF);
-            
-                this->setPixel(x, y, end, offset);
+
+                framebuffer[offset] = end.rgba;
+            }
+
+            /**
+             * @brief Checks if a primitive's bounds reach into the clip rect at all
+             *
+             * @param x X pos
+             * @param y Y pos
+             * @param w Width
+             * @param h Height
+             * @return true if anything of it can be drawn
+             */
+            inline bool isClipVisible(const s32 x, const s32 y, const s32 w, const s32 h) const {
+                return this->m_clip.intersects(x, y, w, h);
             }
             
             /**
@@ -2544,18 +4585,104 @@ namespace tsl {
              * @param color Color
              */
             inline void drawRect(const s32 x, const s32 y, const s32 w, const s32 h, const Color& color) {
-                s32 x_end = x + w;
-                s32 y_end = y + h;
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::Rect, .color = color.rgba, .x = x, .y = y, .w = w, .h = h });
+                    return;
+                }
+
+                // Clip against the layer, the damaged area and the active scissor rect once per rect
+                DamageRect rect{ x, y, x + w, y + h };
+                rect.intersect(this->m_clip);
+                if (rect.empty())
+                    return;
+
+                u16* framebuffer = static_cast<u16*>(this->getCurrentFramebuffer());
+
+                // An opaque color replaces the destination, so it becomes a plain fill with the same result as setPixelBlendDst
+                if (color.a == 0xF) {
+                    const u16 fill = Color((color.r * 0xF) >> 4, (color.g * 0xF) >> 4, (color.b * 0xF) >> 4, 0xF).rgba;
+                    Renderer::forEachSpan(rect, [framebuffer, fill](const u32 offset, const u32 count) {
+                        std::fill_n(framebuffer + offset, count, fill);
+                    });
+                    return;
+                }
+
+                const RGBA4444BlendTable& table = this->getBlendTable(color);
+                Renderer::forEachSpan(rect, [framebuffer, &table](const u32 offset, const u32 count) {
+                    blendRGBA4444Table(framebuffer + offset, table, count);
+                });
+            }
+
             
-                for (s32 yi = y; yi < y_end; ++yi) {
-                    for (s32 xi = x; xi < x_end; ++xi) {
-                        this->setPixelBlendDst(xi, yi, color);
+            /**
+             * @brief Gets the cached scanline extents of a midpoint circle
+             * @note Entry i holds the half width of the row i rows away from the center, the widest span the midpoint
+             *       algorithm reaches on that row
+             *
+             * @param radius Circle radius
+             * @return Row extents of radius + 1 entries
+             */
+            inline const std::vector<s32>& getCircleExtents(const u16 radius) {
+                auto it = this->m_circleExtents.find(radius);
+                if (it != this->m_circleExtents.end())
+                    return it->second;
+
+                std::vector<s32> extents(radius + 1, 0);
+                s32 x = radius;
+                s32 y = 0;
+                s32 radiusError = 0;
+                s32 xChange = 1 - (radius << 1);
+                s32 yChange = 0;
+
+                while (x >= y) {
+                    extents[y] = std::max(extents[y], x);
+                    extents[x] = std::max(extents[x], y);
+
+                    y++;
+                    radiusError += yChange;
+                    yChange += 2;
+
+                    if (((radiusError << 1) + xChange) > 0) {
+                        x--;
+                        radiusError += xChange;
+                        xChange += 2;
+                    }
+                }
+
+                return this->m_circleExtents.emplace(radius, std::move(extents)).first->second;
+            }
+
+            /**
+             * @brief Draws a circle
+             * @note Filled circles are drawn as one span per row from the cached extents, so every pixel is blended once
+             *
+             * @param centerX Center X pos
+             * @param centerY Center Y pos
+             * @param radius Radius
+             * @param filled Fill the circle or only draw its outline
+             * @param color Color
+             */
+            inline void drawCircle(const s32 centerX, const s32 centerY, const u16 radius, const bool filled, const Color& color) {
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::Circle, .flags = filled, .color = color.rgba, .x = centerX, .y = centerY, .param = radius });
+                    return;
+                }
+
+                if (!this->isClipVisible(centerX - radius, centerY - radius, 2 * radius + 1, 2 * radius + 1))
+                    return;
+
+                if (filled) {
+                    const std::vector<s32>& extents = this->getCircleExtents(radius);
+                    const s32 rowStart = std::max(centerY - radius, this->m_clip.y0);
+                    const s32 rowEnd = std::min(centerY + radius + 1, this->m_clip.y1);
+                    s32 extent;
+                    for (s32 row = rowStart; row < rowEnd; ++row) {
+                        extent = extents[std::abs(row - centerY)];
+                        this->drawRect(centerX - extent, row, 2 * extent + 1, 1, color);
                     }
+                    return;
                 }
-            }
 
-            
-            inline void drawCircle(const s32 centerX, const s32 centerY, const u16 radius, const bool filled, const Color& color) {
                 s32 x = radius;
                 s32 y = 0;
                 s32 radiusError = 0;
@@ -2563,26 +4690,14 @@ namespace tsl {
                 s32 yChange = 0;
                 
                 while (x >= y) {
-                    if (filled) {
-                        for (s32 i = centerX - x; i <= centerX + x; i++) {
-                            this->setPixelBlendDst(i, centerY + y, color);
-                            this->setPixelBlendDst(i, centerY - y, color);
-                        }
-                        
-                        for (s32 i = centerX - y; i <= centerX + y; i++) {
-                            this->setPixelBlendDst(i, centerY + x, color);
-                            this->setPixelBlendDst(i, centerY - x, color);
-                        }
-                    } else {
-                        this->setPixelBlendDst(centerX + x, centerY + y, color);
-                        this->setPixelBlendDst(centerX + y, centerY + x, color);
-                        this->setPixelBlendDst(centerX - y, centerY + x, color);
-                        this->setPixelBlendDst(centerX - x, centerY + y, color);
-                        this->setPixelBlendDst(centerX - x, centerY - y, color);
-                        this->setPixelBlendDst(centerX - y, centerY - x, color);
-                        this->setPixelBlendDst(centerX + y, centerY - x, color);
-                        this->setPixelBlendDst(centerX + x, centerY - y, color);
-                    }
+                    this->setPixelBlendDst(centerX + x, centerY + y, color);
+                    this->setPixelBlendDst(centerX + y, centerY + x, color);
+                    this->setPixelBlendDst(centerX - y, centerY + x, color);
+                    this->setPixelBlendDst(centerX - x, centerY + y, color);
+                    this->setPixelBlendDst(centerX - x, centerY - y, color);
+                    this->setPixelBlendDst(centerX - y, centerY - x, color);
+                    this->setPixelBlendDst(centerX + y, centerY - x, color);
+                    this->setPixelBlendDst(centerX + x, centerY - y, color);
                     
                     y++;
                     radiusError += yChange;
@@ -2596,7 +4711,40 @@ namespace tsl {
                 }
             }
 
+            /**
+             * @brief Draws a quarter of a circle
+             *
+             * @param centerX Center X pos
+             * @param centerY Center Y pos
+             * @param radius Radius
+             * @param filled Fill the quarter or only draw its outline
+             * @param color Color
+             * @param quadrant 1 top-right, 2 top-left, 3 bottom-left, 4 bottom-right
+             */
             inline void drawQuarterCircle(s32 centerX, s32 centerY, u16 radius, bool filled, const Color& color, int quadrant) {
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::QuarterCircle, .flags = static_cast<u8>(filled | (quadrant << 1)), .color = color.rgba,
+                                .x = centerX, .y = centerY, .param = radius });
+                    return;
+                }
+
+                if (!this->isClipVisible(centerX - radius, centerY - radius, 2 * radius + 1, 2 * radius + 1))
+                    return;
+
+                if (filled) {
+                    const std::vector<s32>& extents = this->getCircleExtents(radius);
+                    const bool top = quadrant == 1 || quadrant == 2;
+                    const bool left = quadrant == 2 || quadrant == 3;
+                    const s32 rowStart = std::max(top ? centerY - radius : centerY, this->m_clip.y0);
+                    const s32 rowEnd = std::min(top ? centerY + 1 : centerY + radius + 1, this->m_clip.y1);
+                    s32 extent;
+                    for (s32 row = rowStart; row < rowEnd; ++row) {
+                        extent = extents[std::abs(row - centerY)];
+                        this->drawRect(left ? centerX - extent : centerX, row, extent + 1, 1, color);
+                    }
+                    return;
+                }
+
                 s32 x = radius;
                 s32 y = 0;
                 s32 radiusError = 0;
@@ -2604,60 +4752,23 @@ namespace tsl {
                 s32 yChange = 0;
                 
                 while (x >= y) {
-                    if (filled) {
-                        switch (quadrant) {
-                            case 1: // Top-right
-                                for (s32 i = centerX; i <= centerX + x; i++) {
-                                    this->setPixelBlendDst(i, centerY - y, color);
-                                }
-                                for (s32 i = centerX; i <= centerX + y; i++) {
-                                    this->setPixelBlendDst(i, centerY - x, color);
-                                }
-                                break;
-                            case 2: // Top-left
-                                for (s32 i = centerX - x; i <= centerX; i++) {
-                                    this->setPixelBlendDst(i, centerY - y, color);
-                                }
-                                for (s32 i = centerX - y; i <= centerX; i++) {
-                                    this->setPixelBlendDst(i, centerY - x, color);
-                                }
-                                break;
-                            case 3: // Bottom-left
-                                for (s32 i = centerX - x; i <= centerX; i++) {
-                                    this->setPixelBlendDst(i, centerY + y, color);
-                                }
-                                for (s32 i = centerX - y; i <= centerX; i++) {
-                                    this->setPixelBlendDst(i, centerY + x, color);
-                                }
-                                break;
-                            case 4: // Bottom-right
-                                for (s32 i = centerX; i <= centerX + x; i++) {
-                                    this->setPixelBlendDst(i, centerY + y, color);
-                                }
-                                for (s32 i = centerX; i <= centerX + y; i++) {
-                                    this->setPixelBlendDst(i, centerY + x, color);
-                                }
-                                break;
-                        }
-                    } else {
-                        switch (quadrant) {
-                            case 1: // Top-right
-                                this->setPixelBlendDst(centerX + x, centerY - y, color);
-                                this->setPixelBlendDst(centerX + y, centerY - x, color);
-                                break;
-                            case 2: // Top-left
-                                this->setPixelBlendDst(centerX - x, centerY - y, color);
-                                this->setPixelBlendDst(centerX - y, centerY - x, color);
-                                break;
-                            case 3: // Bottom-left
-                                this->setPixelBlendDst(centerX - x, centerY + y, color);
-                                this->setPixelBlendDst(centerX - y, centerY + x, color);
-                                break;
-                            case 4: // Bottom-right
-                                this->setPixelBlendDst(centerX + x, centerY + y, color);
-                                this->setPixelBlendDst(centerX + y, centerY + x, color);
-                                break;
-                        }
+                    switch (quadrant) {
+                        case 1: // Top-right
+                            this->setPixelBlendDst(centerX + x, centerY - y, color);
+                            this->setPixelBlendDst(centerX + y, centerY - x, color);
+                            break;
+                        case 2: // Top-left
+                            this->setPixelBlendDst(centerX - x, centerY - y, color);
+                            this->setPixelBlendDst(centerX - y, centerY - x, color);
+                            break;
+                        case 3: // Bottom-left
+                            this->setPixelBlendDst(centerX - x, centerY + y, color);
+                            this->setPixelBlendDst(centerX - y, centerY + x, color);
+                            break;
+                        case 4: // Bottom-right
+                            this->setPixelBlendDst(centerX + x, centerY + y, color);
+                            this->setPixelBlendDst(centerX + y, centerY + x, color);
+                            break;
                     }
                     
                     y++;
@@ -2692,82 +4803,35 @@ namespace tsl {
             }
 
 
-            // Define processChunk as a static member function
-            static void processRoundedRectChunk(Renderer* self, const s32 x, const s32 y, const s32 x_end, const s32 y_end, const s32 r2, const s32 radius, const Color& color, const s32 startRow, const s32 endRow) {
-                s32 x_left = x + radius;
-                s32 x_right = x_end - radius;
-                s32 y_top = y + radius;
-                s32 y_bottom = y_end - radius;
-                
-                // Process the rectangle in chunks
-                for (s32 y1 = startRow; y1 < endRow; ++y1) {
-                    for (s32 x1 = x; x1 < x_end; ++x1) {
-                        //bool isInCorner = false;
-            
-                        if (x1 < x_left) {
-                            // Left side
-                            if (y1 < y_top) {
-                                // Top-left corner
-                                s32 dx = x_left - x1;
-                                s32 dy = y_top - y1;
-                                if (dx * dx + dy * dy <= r2) {
-                                    self->setPixelBlendDst(x1, y1, color);
-                                }
-                            } else if (y1 >= y_bottom) {
-                                // Bottom-left corner
-                                s32 dx = x_left - x1;
-                                s32 dy = y1 - y_bottom;
-                                if (dx * dx + dy * dy <= r2) {
-                                    self->setPixelBlendDst(x1, y1, color);
-                                }
-                            } else {
-                                // Left side of the rectangle
-                                self->setPixelBlendDst(x1, y1, color);
-                            }
-                        } else if (x1 >= x_right) {
-                            // Right side
-                            if (y1 < y_top) {
-                                // Top-right corner
-                                s32 dx = x1 - x_right;
-                                s32 dy = y_top - y1;
-                                if (dx * dx + dy * dy <= r2) {
-                                    self->setPixelBlendDst(x1, y1, color);
-                                }
-                            } else if (y1 >= y_bottom) {
-                                // Bottom-right corner
-                                s32 dx = x1 - x_right;
-                                s32 dy = y1 - y_bottom;
-                                if (dx * dx + dy * dy <= r2) {
-                                    self->setPixelBlendDst(x1, y1, color);
-                                }
-                            } else {
-                                // Right side of the rectangle
-                                self->setPixelBlendDst(x1, y1, color);
-                            }
-                        } else {
-                            self->setPixelBlendDst(x1, y1, color);
-                            // Center part
-                            //if (y1 < y_top || y1 >= y_bottom) {
-                            //    // Top and Bottom sides
-                            //    isInCorner = true;
-                            //} else {
-                            //    // Center area inside rectangle
-                            //    isInCorner = true;
-                            //}
-                        }
-            
-                        // Set the pixel color if it's in the corner or filled area
-                        //if (isInCorner) {
-                        //    self->setPixelBlendDst(x1, y1, color);
-                        //}
-                    }
+            /**
+             * @brief Gets the cached corner mask of a radius
+             * @note Entry i holds how many columns past the straight edge are inside the corner on the row that
+             *       lies i rows past it, that is the largest dx with dx * dx + i * i <= radius * radius
+             *
+             * @param radius Corner radius
+             * @return Corner mask of radius + 1 entries
+             */
+            inline const std::vector<s32>& getCornerMask(const s32 radius) {
+                auto it = this->m_cornerMasks.find(radius);
+                if (it != this->m_cornerMasks.end())
+                    return it->second;
+
+                std::vector<s32> mask(radius + 1);
+                const s32 r2 = radius * radius;
+                s32 dx = radius;
+                for (s32 dy = 0; dy <= radius; ++dy) {
+                    while (dx * dx + dy * dy > r2)
+                        --dx;
+                    mask[dy] = dx;
                 }
-            }
-
 
+                return this->m_cornerMasks.emplace(radius, std::move(mask)).first->second;
+            }
 
             /**
              * @brief Draws a rounded rectangle of given sizes and corner radius
+             * @note The straight middle is a single rect fill and every corner row collapses into one horizontal
+             *       span through the cached corner mask, so no pixel is distance tested while drawing
              *
              * @param x X pos
              * @param y Y pos
@@ -2776,55 +4840,45 @@ namespace tsl {
              * @param radius Corner radius
              * @param color Color
              */
-            inline void drawRoundedRectMultiThreaded(const s32 x, const s32 y, const s32 w, const s32 h, const s32 radius, const Color& color) {
-                s32 x_end = x + w;
-                s32 y_end = y + h;
-                s32 r2 = radius * radius;
-            
-                // Reuse threads and implement work-stealing
-                currentRow = y;
-            
-                auto threadTask = [this, x, y, x_end, y_end, r2, radius, color]() {
-                    s32 startRow;
-                    while (true) {
-                        startRow = currentRow.fetch_add(4);
-                        if (startRow >= y_end) break;
-                        //s32 endRow = std::min(startRow + 4,y_end); // Process one row at a time
-                        processRoundedRectChunk(this, x, y, x_end, y_end, r2, radius, color, startRow, std::min(startRow + 4,y_end));
-                    }
-                };
-            
-                // Launch threads
-                for (unsigned i = 0; i < numThreads; ++i) {
-                    threads[i] = std::thread(threadTask);
-                }
-            
-                // Join threads
-                for (auto& t : threads) {
-                    if (t.joinable()) t.join();
+            inline void drawRoundedRect(const s32 x, const s32 y, const s32 w, const s32 h, s32 radius, const Color& color) {
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::RoundedRect, .color = color.rgba, .x = x, .y = y, .w = w, .h = h, .param = radius });
+                    return;
                 }
-            }
 
+                if (w <= 0 || h <= 0 || !this->isClipVisible(x, y, w, h))
+                    return;
 
-            inline void drawRoundedRectSingleThreaded(const s32 x, const s32 y, const s32 w, const s32 h, const s32 radius, const Color& color) {
-                s32 x_end = x + w;
-                s32 y_end = y + h;
-                s32 r2 = radius * radius;
-                
-                // Call the processRoundedRectChunk function directly for the entire rectangle
-                processRoundedRectChunk(this, x, y, x_end, y_end, r2, radius, color, y, y_end);
-            }
+                radius = std::max(radius, 0);
+                const std::vector<s32>& mask = this->getCornerMask(radius);
+
+                const s32 x_end = x + w;
+                const s32 y_end = y + h;
+                const s32 x_left = x + radius;
+                const s32 x_right = x_end - radius;
+                const s32 y_top = y + radius;
+                const s32 y_bottom = y_end - radius;
+
+                // Straight middle rows cover the full width
+                const s32 middleStart = std::max(y, y_top);
+                const s32 middleEnd = std::min(y_end, y_bottom);
+                if (middleStart < middleEnd)
+                    this->drawRect(x, middleStart, w, middleEnd - middleStart, color);
+
+                // Corner rows, the left corner starts one column before x_left and the right one at x_right
+                s32 dy, spanStart, spanEnd;
+                for (s32 row = std::max(y, this->m_clip.y0); row < std::min(y_end, this->m_clip.y1); ++row) {
+                    if (row < y_top)
+                        dy = y_top - row;
+                    else if (row >= y_bottom)
+                        dy = row - y_bottom;
+                    else
+                        continue;
 
-            std::function<void(s32, s32, s32, s32, s32, Color)> drawRoundedRect;
-            inline void updateDrawFunction() {
-                if (expandedMemory) {
-                    drawRoundedRect = [this](s32 x, s32 y, s32 w, s32 h, s32 radius, Color color) {
-                        drawRoundedRectMultiThreaded(x, y, w, h, radius, color);
-                    };
-                } else {
-                    drawRoundedRect = [this](s32 x, s32 y, s32 w, s32 h, s32 radius, Color color) {
-                        drawRoundedRectSingleThreaded(x, y, w, h, radius, color);
-                    };
+                    spanStart = std::max(x, x_left - mask[dy]);
+                    spanEnd = std::min(x_end - 1, std::max(x_left - 1, x_right + mask[dy]));
+                    if (spanStart <= spanEnd)
+                        this->drawRect(spanStart, row, spanEnd - spanStart + 1, 1, color);
                 }
             }
 
@@ -2873,227 +4927,295 @@ namespace tsl {
 
             
             
+            /**
+             * @brief Draws a rounded rectangle whose corner radius is half its shorter side, e.g. a track bar
+             * @note Goes through \ref drawRoundedRect, so it records as a single command and draws from the cached corner mask
+             *
+             * @param x X pos
+             * @param y Y pos
+             * @param w Width
+             * @param h Height
+             * @param color Color
+             */
             inline void drawUniformRoundedRect(const s32 x, const s32 y, const s32 w, const s32 h, const Color& color) {
-                s32 radius = std::min(w, h) / 2;
-                s32 x_start = x + radius;
-                s32 x_end = x + w - radius;
-                s32 y_start = y + radius;
-                s32 y_end = y + h - radius;
-            
-                // Draw the central rectangle excluding the corners
-                for (s32 y1 = y_start; y1 < y_end; ++y1) {
-                    for (s32 x1 = x_start; x1 < x_end; ++x1) {
-                        this->setPixelBlendDst(x1, y1, color);
-                    }
-                }
-            
-                // Draw the top and bottom rectangles excluding the corners
-                for (s32 y1 = y; y1 < y_start; ++y1) {
-                    for (s32 x1 = x_start; x1 < x_end; ++x1) {
-                        this->setPixelBlendDst(x1, y1, color);
-                    }
-                }
-                for (s32 y1 = y_end; y1 < y + h; ++y1) {
-                    for (s32 x1 = x_start; x1 < x_end; ++x1) {
-                        this->setPixelBlendDst(x1, y1, color);
-                    }
-                }
-            
-                // Draw the left and right rectangles excluding the corners
-                for (s32 y1 = y_start; y1 < y_end; ++y1) {
-                    for (s32 x1 = x; x1 < x_start; ++x1) {
-                        this->setPixelBlendDst(x1, y1, color);
-                    }
-                    for (s32 x1 = x_end; x1 < x + w; ++x1) {
-                        this->setPixelBlendDst(x1, y1, color);
-                    }
-                }
-                
-                // Draw the rounded corners ensuring smooth arcs
-                s32 radiusSquared = radius * radius;
-                s32 cornerX = x + radius;
-                s32 cornerY = y + radius;
-            
-                for (s32 x1 = 0; x1 < radius; ++x1) {
-                    for (s32 y1 = 0; y1 < radius; ++y1) {
-                        if ((x1 * x1 + y1 * y1) <= radiusSquared) {
-                            // Top-left corner
-                            this->setPixelBlendDst(cornerX - x1, cornerY - y1, color);
-                            // Top-right corner
-                            this->setPixelBlendDst(x + w - radius + x1, cornerY - y1, color);
-                            // Bottom-left corner
-                            this->setPixelBlendDst(cornerX - x1, y + h - radius + y1, color);
-                            // Bottom-right corner
-                            this->setPixelBlendDst(x + w - radius + x1, y + h - radius + y1, color);
-                        }
-                    }
-                }
+                this->drawRoundedRect(x, y, w, h, std::min(w, h) / 2, color);
             }
 
             
             inline void processBMPChunk(const s32 x, const s32 y, const s32 screenW, const u8 *preprocessedData, const s32 startRow, const s32 endRow) {
-                s32 bytesPerRow = screenW * 4;
-                const s32 endX = screenW - 16;
-                
+                const s32 bytesPerRow = screenW * 4;
+
+                // Clip against the layer, the damaged area and the active scissor rect once per chunk
+                const s32 clipY0 = this->m_clip.y0, clipY1 = this->m_clip.y1;
+                const s32 spanStart = std::max(x, this->m_clip.x0);
+                const s32 spanEnd = std::min(x + screenW, this->m_clip.x1);
+                if (spanStart >= spanEnd)
+                    return;
+
+                u16* framebuffer = static_cast<u16*>(this->getCurrentFramebuffer());
+                const u8 *rowPtr;
+                s32 screenY, runStart, runEnd;
+
                 for (s32 y1 = startRow; y1 < endRow; ++y1) {
-                    const u8 *rowPtr = preprocessedData + (y1 * bytesPerRow);
-                    s32 x1 = 0;
-                    
-                    // Process in chunks of 16 pixels using SIMD
-                    for (; x1 <= endX; x1 += 16) {
-                        uint8x16x4_t pixelData = vld4q_u8(rowPtr + (x1 * 4));
-                        
-                        // Unroll the loop to reduce the number of operations
-                        for (s32 i = 0; i < 16; ++i) {
-                            setPixelBlendSrc(x + x1 + i, y + y1, {
-                                pixelData.val[0][i],
-                                pixelData.val[1][i],
-                                pixelData.val[2][i],
-                                pixelData.val[3][i]
-                            });
-                        }
-                    }
-            
-                    // Handle the remaining pixels (less than 16)
-                    for (s32 xRem = x1; xRem < screenW; ++xRem) {
-                        const u8 *p = rowPtr + (xRem * 4);
-                        setPixelBlendSrc(x + xRem, y + y1, {p[0], p[1], p[2], p[3]});
+                    screenY = y + y1;
+                    if (screenY < clipY0 || screenY >= clipY1)
+                        continue;
+
+                    rowPtr = preprocessedData + (y1 * bytesPerRow);
+
+                    // Each aligned group of 8 columns is contiguous in the block-linear layout
+                    for (runStart = spanStart; runStart < spanEnd; runStart = runEnd) {
+                        runEnd = std::min((runStart & ~7) + 8, spanEnd);
+                        blendRGBA4444(framebuffer + getBlockLinearOffset(runStart, screenY), rowPtr + (runStart - x) * 4, runEnd - runStart);
                     }
                 }
-                //inPlot.store(false, std::memory_order_release);
-                inPlotBarrier.arrive_and_wait(); // Wait for all threads to reach this point
             }
 
 
             /**
-             * @brief Draws a scaled RGBA8888 bitmap from memory
+             * @brief Draws an unscaled bitmap from memory, blended over the framebuffer
+             * @note The data holds one byte per channel in RGBA order, of which only the low nibble is used,
+             *       i.e. RGBA4444 values unpacked to bytes. Full 8 bit channels have to be shifted right by 4 first.
+             *       A recorded frame keeps only the pointer. The data has to outlive the frame, which holds for
+             *       anything owned by a Gui since the Overlay waits for the render thread before destroying one
              *
              * @param x X start position
              * @param y Y start position
-             * @param w Bitmap width (original width of the bitmap)
-             * @param h Bitmap height (original height of the bitmap)
-             * @param bmp Pointer to bitmap data
-             * @param screenW Target screen width
-             * @param screenH Target screen height
+             * @param screenW Bitmap width
+             * @param screenH Bitmap height
+             * @param preprocessedData Pointer to bitmap data
              */
 
             inline void drawBitmap(const s32 x, const s32 y, const s32 screenW, const s32 screenH, const u8 *preprocessedData) {
-                // Number of threads to use
-                //const unsigned numThreads = 3;
-                //std::vector<std::thread> threads(numThreads);
-
-                // Divide rows among threads
-                //s32 chunkSize = (screenH + numThreads - 1) / numThreads;
-                for (unsigned i = 0; i < numThreads; ++i) {
-                    s32 startRow = i * bmpChunkSize;
-                    s32 endRow = std::min(startRow + bmpChunkSize, screenH);
-                    
-                    // Bind the member function and create the thread
-                    threads[i] = std::thread(std::bind(&tsl::gfx::Renderer::processBMPChunk, this, x, y, screenW, preprocessedData, startRow, endRow));
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::Bitmap, .x = x, .y = y, .w = screenW, .h = screenH, .data = preprocessedData });
+                    return;
                 }
-            
-                // Join all threads
-                for (auto& t : threads) {
-                    t.join();
+
+                // Divide rows among the persistent raster workers (runs inline when numThreads == 0)
+                this->m_rasterPool.run(0, screenH, bmpChunkSize, [this, x, y, screenW, preprocessedData](const s32 startRow, const s32 endRow) {
+                    this->processBMPChunk(x, y, screenW, preprocessedData, startRow, endRow);
+                });
+            }
+
+            /**
+             * @brief Draws the pre-swizzled wallpaper over a uniform background color
+             * @note Replaces \ref fillScreen. Opaque wallpapers are copied straight into the framebuffer,
+             *       translucent ones are blended against the background color in framebuffer order.
+             *
+             * @param backgroundColor Background color with opacity applied
+             */
+            inline void drawWallpaper(const Color& backgroundColor) {
+                if (DisplayList* list = Renderer::s_recording) {
+                    this->latchDamage();
+                    list->add({ .type = DisplayList::CommandType::Wallpaper, .color = backgroundColor.rgba });
+                    return;
                 }
+
+                // Only the thread reading wallpaperData flags it, a wallpaper reload waits for inPlot to drop.
+                // The wallpaper may have started reloading since the frame got recorded
+                inPlot.store(true, std::memory_order_release);
+                if (!refreshWallpaper.load(std::memory_order_acquire))
+                    this->blitWallpaper(backgroundColor);
+                else
+                    this->fillScreen(backgroundColor);
+                inPlot.store(false, std::memory_order_release);
             }
 
-            
+            /**
+             * @brief Copies or blends wallpaperData into the damaged area, see \ref drawWallpaper
+             * @note The caller has to hold off wallpaper reloads through inPlot
+             *
+             * @param backgroundColor Background color with opacity applied
+             */
+            inline void blitWallpaper(const Color& backgroundColor) {
+                u16* framebuffer = static_cast<u16*>(this->getCurrentFramebuffer());
+                const u16* wallpaper = wallpaperData.data();
+
+                if (wallpaperData.size() != 448 * 720 || this->getFramebufferSize() < 448 * 768 * sizeof(u16)) {
+                    this->fillScreen(backgroundColor);
+                    return;
+                }
+
+                this->latchDamage();
+                const bool fullFrame = this->isFullFrameDamage();
+
+                if (wallpaperOpaque) {
+                    // The resulting alpha is the background's, re-bake it when the layer opacity changed
+                    if (wallpaperBakedAlpha != backgroundColor.a) {
+                        const u16 alphaBits = static_cast<u16>(backgroundColor.a) << 12;
+                        for (u16& px : wallpaperData) {
+                            px = (px & 0x0FFF) | alphaBits;
+                        }
+                        wallpaperBakedAlpha = backgroundColor.a;
+                    }
+
+                    if (fullFrame) {
+                        forEachWallpaperSpan([framebuffer, wallpaper](const u32 framebufferOffset, const u32 wallpaperOffset, const u32 count) {
+                            std::memcpy(framebuffer + framebufferOffset, wallpaper + wallpaperOffset, count * sizeof(u16));
+                        });
+                    } else {
+                        this->forEachDamagedRun([framebuffer, wallpaper](const s32 x, const s32 y, const s32 count) {
+                            std::memcpy(framebuffer + getBlockLinearOffset(x, y), wallpaper + getPackedWallpaperOffset(x, y), count * sizeof(u16));
+                        });
+                    }
+                } else {
+                    // Both buffers share the same layout, so blend them span by span
+                    this->fillScreen(backgroundColor);
+                    if (fullFrame) {
+                        forEachWallpaperSpan([framebuffer, wallpaper](const u32 framebufferOffset, const u32 wallpaperOffset, const u32 count) {
+                            blendRGBA4444Packed(framebuffer + framebufferOffset, wallpaper + wallpaperOffset, count);
+                        });
+                    } else {
+                        this->forEachDamagedRun([framebuffer, wallpaper](const s32 x, const s32 y, const s32 count) {
+                            blendRGBA4444Packed(framebuffer + getBlockLinearOffset(x, y), wallpaper + getPackedWallpaperOffset(x, y), count);
+                        });
+                    }
+                }
+            }
+
+
             /**
              * @brief Fills the entire layer with a given color
+             * @note Only the damaged area is touched, everything else already holds the same content
              *
              * @param color Color
              */
             inline void fillScreen(const Color& color) {
-                std::fill_n(static_cast<Color*>(this->getCurrentFramebuffer()), this->getFramebufferSize() / sizeof(Color), color);
+                this->latchDamage();
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::FillScreen, .color = color.rgba });
+                    return;
+                }
+
+                Color* framebuffer = static_cast<Color*>(this->getCurrentFramebuffer());
+                if (this->isFullFrameDamage()) {
+                    std::fill_n(framebuffer, this->getFramebufferSize() / sizeof(Color), color);
+                    return;
+                }
+
+                Renderer::forEachSpan(this->m_damage, [framebuffer, &color](const u32 offset, const u32 count) {
+                    std::fill_n(framebuffer + offset, count, color);
+                });
             }
-            
+
             /**
              * @brief Clears the layer (With transparency)
              *
              */
             inline void clearScreen() {
-                this->fillScreen({ 0x00, 0x00, 0x00, 0x00 });
+                // Always clear everything, and since the result matches no regular frame, repaint everything afterwards
+                this->latchDamage();
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->damage = Renderer::getLayerRect();
+                    list->add({ .type = DisplayList::CommandType::ClearScreen });
+                } else {
+                    this->clearLayer();
+                }
+                Renderer::invalidateAll();
             }
             
-            struct Glyph {
-                stbtt_fontinfo *currFont;
-                float currFontSize;
-                int bounds[4];
-                int xAdvance;
-                u8 *glyphBmp;
-                int width, height;
-            };
-            
+            /**
+             * @brief Measures a string
+             * @note The result is cached per string, font size and flag, see \ref TextRun
+             *
+             * @param str String
+             * @param fontSize Height of the text in pixels
+             * @param fixedWidthNumbers Give every digit the same width
+             * @return Width in pixels
+             */
             inline float calculateStringWidth(const std::string& str, const s32 fontSize, const bool fixedWidthNumbers = false) {
                 if (str.empty()) {
                     return 0.0f;
                 }
-            
-                float totalWidth = 0.0f;
-                std::string::size_type strPos = 0;
+
+                std::lock_guard<std::recursive_mutex> lock(this->m_textMutex);
+                TextRun& run = Renderer::s_textRuns.get(str, fontSize, fixedWidthNumbers);
+                if (run.prefixWidths.empty())
+                    this->measureTextRun(run);
+
+                return run.prefixWidths.back();
+            }
+
+            /**
+             * @brief Gets a glyph from the atlas, rasterizing it on a miss
+             *
+             * @param codepoint Unicode codepoint
+             * @param monospace Use the monospace advance
+             * @param fontSize Height of the text in pixels
+             * @return Cached glyph, valid until the next call
+             */
+            inline Glyph* getGlyph(const u32 codepoint, const bool monospace, const s32 fontSize) {
+                const u64 key = getGlyphKey(codepoint, monospace, fontSize);
+                if (Glyph* cached = Renderer::s_glyphAtlas.find(key))
+                    return cached;
+
+                return Renderer::s_glyphAtlas.insert(key, this->rasterizeGlyph(codepoint, monospace, fontSize));
+            }
+
+            /**
+             * @brief Rasterizes glyphs in the background so the first menus draw their text from the atlas
+             * @note Covers the loaded language strings, printable ASCII and the button and menu symbols at the
+             *       font sizes the menus use. Stops early once it used up half of the atlas budget or got cancelled.
+             */
+            void prewarmGlyphs() {
+                this->cancelGlyphPrewarm();
+
+                std::string text = languageGlyphText;
+                for (char c = 0x21; c < 0x7F; ++c) {
+                    text += c;
+                }
+                for (const auto& keyInfo : impl::KEYS_INFO) {
+                    text += keyInfo.glyph;
+                }
+                text += OPTION_SYMBOL + DROPDOWN_SYMBOL + CHECKMARK_SYMBOL + CROSSMARK_SYMBOL + STAR_SYMBOL +
+                        DOWNLOAD_SYMBOL + UNZIP_SYMBOL + COPY_SYMBOL + INPROGRESS_SYMBOL;
+                for (const auto& throbber : THROBBER_SYMBOLS) {
+                    text += throbber;
+                }
+
+                // Every codepoint once, in order of appearance
+                std::unordered_set<u32> seen;
+                this->m_prewarmCodepoints.clear();
+                u32 codepoint;
                 ssize_t codepointWidth;
-                u32 prevCharacter = 0;
-                u32 currCharacter = 0;
-                float currFontSize;
-                int xAdvance = 0, leftBearing = 0, kernAdvance = 0;
-            
-                // Cache default width for numeric characters if fixedWidthNumbers is true
-                float numericCharWidth = fixedWidthNumbers ? defaultNumericCharWidth * fontSize : 0.0f;
-            
-                // Prepare the font information ahead of time if possible
-                stbtt_fontinfo* currentFont = nullptr;
-            
-                // Use an iterator for characterWidths map lookup
-                auto it = characterWidths.end();
-            
-                while (strPos < str.size()) {
-                    codepointWidth = decode_utf8(&currCharacter, reinterpret_cast<const u8*>(&str[strPos]));
-                    if (codepointWidth <= 0) {
+                for (size_t pos = 0; pos < text.size(); pos += codepointWidth) {
+                    codepointWidth = decode_utf8(&codepoint, reinterpret_cast<const u8*>(text.data() + pos));
+                    if (codepointWidth <= 0)
                         break;
-                    }
-            
-                    if (fixedWidthNumbers && std::isdigit(currCharacter)) {
-                        totalWidth += numericCharWidth;
-                    } else {
-                        // Check if the character is found in the cache
-                        it = characterWidths.find(static_cast<wchar_t>(currCharacter));
-                        if (it != characterWidths.end()) {
-                            totalWidth += it->second * fontSize;
-                        } else {
-                            if (!currentFont || !stbtt_FindGlyphIndex(currentFont, currCharacter)) {
-                                if (stbtt_FindGlyphIndex(&this->m_extFont, currCharacter)) {
-                                    currentFont = &this->m_extFont;
-                                } else if (this->m_hasLocalFont && stbtt_FindGlyphIndex(&this->m_stdFont, currCharacter) == 0) {
-                                    currentFont = &this->m_localFont;
-                                } else {
-                                    currentFont = &this->m_stdFont;
-                                }
-                            }
-            
-                            currFontSize = stbtt_ScaleForPixelHeight(currentFont, fontSize);
-                            stbtt_GetCodepointHMetrics(currentFont, currCharacter, &xAdvance, &leftBearing);
-            
-                            if (prevCharacter) {
-                                kernAdvance = stbtt_GetCodepointKernAdvance(currentFont, prevCharacter, currCharacter);
-                                totalWidth += kernAdvance * currFontSize;
-                            }
-            
-                            totalWidth += xAdvance * currFontSize;
-                        }
-                    }
-            
-                    strPos += codepointWidth;
-                    prevCharacter = currCharacter;
+                    if (!std::iswspace(codepoint) && seen.insert(codepoint).second)
+                        this->m_prewarmCodepoints.push_back(codepoint);
                 }
-            
-                return totalWidth;
-            }
-
 
+                this->m_prewarmCancel.store(false, std::memory_order_relaxed);
+                if (R_SUCCEEDED(threadCreate(&this->m_prewarmThread, Renderer::prewarmThreadFunc, this, nullptr, 0x4000, 0x3F, -2))) {
+                    this->m_prewarmThreadCreated = true;
+                    threadStart(&this->m_prewarmThread);
+                }
+            }
 
+            /**
+             * @brief Stops a running glyph prewarm and waits for it to exit
+             * @note Glyphs it finished are kept and still end up in the atlas
+             */
+            void cancelGlyphPrewarm() {
+                if (!this->m_prewarmThreadCreated)
+                    return;
 
+                this->m_prewarmCancel.store(true, std::memory_order_relaxed);
+                threadWaitForExit(&this->m_prewarmThread);
+                threadClose(&this->m_prewarmThread);
+                this->m_prewarmThreadCreated = false;
+            }
 
+            /**
+             * @brief Gets the glyph cache shared by all text drawing
+             *
+             * @return Glyph atlas
+             */
+            inline static GlyphAtlas& getGlyphAtlas() {
+                return Renderer::s_glyphAtlas;
+            }
 
             /**
              * @brief Draws a string
@@ -3107,11 +5229,8 @@ namespace tsl {
              * @return Dimensions of drawn string
              */
             inline std::pair<u32, u32> drawString(const std::string& originalString, bool monospace, const s32 x, const s32 y, const s32 fontSize, const Color& color, const ssize_t maxWidth = 0) {
-                float maxX = x;
-                float currX = x;
-                float currY = y;
-                
-                
+                std::lock_guard<std::recursive_mutex> lock(this->m_textMutex);
+
                 // Avoid copying the original string
                 const std::string* stringPtr = &originalString;
                 
@@ -3131,41 +5250,55 @@ namespace tsl {
                     }
                 }
             
-                // Cache the end iterator for efficiency
-                auto itStrEnd = stringPtr->cend();
-                auto itStr = stringPtr->cbegin();
+                if (stringPtr->empty())
+                    return { 0, 0 };
+
+                // A recorded string gets measured now, since callers lay out with the result, and rasterized on replay
+                if (DisplayList* list = Renderer::s_recording) {
+                    if (color.a != 0x0)
+                        list->addString(*stringPtr, monospace, x, y, fontSize, color, static_cast<s32>(maxWidth));
+                    return this->drawTextRun(*stringPtr, monospace, x, y, fontSize, color, maxWidth, true);
+                }
+
+                return this->drawTextRun(*stringPtr, monospace, x, y, fontSize, color, maxWidth, color.a == 0x0);
+            }
+
+            /**
+             * @brief Lays out and draws a string that is already resolved
+             * @warning Requires the text mutex to be held
+             *
+             * @param string String to draw
+             * @param monospace Draw string in monospace font
+             * @param x X pos
+             * @param y Y pos
+             * @param fontSize Height of the text drawn in pixels
+             * @param color Text color
+             * @param maxWidth Max width, 0 for none
+             * @param measureOnly Only lay out the string without touching the framebuffer
+             * @return Dimensions of the string
+             */
+            inline std::pair<u32, u32> drawTextRun(const std::string& string, const bool monospace, const s32 x, const s32 y, const s32 fontSize, const Color& color, const ssize_t maxWidth, const bool measureOnly) {
+                float maxX = x;
+                float currX = x;
+                float currY = y;
+
+                // Decoded once per string, a measurement without max width is kept as well
+                TextRun& run = Renderer::s_textRuns.get(string, fontSize, monospace);
+                if (measureOnly && maxWidth <= 0 && run.drawMeasured)
+                    return { run.drawWidth, run.drawHeight };
                 
                 // Move variable declarations outside of the loop
-                u32 currCharacter = 0;
-                ssize_t codepointWidth = 0;
-                u64 key = 0;
                 Glyph* glyph = nullptr;
                 
                 float xPos = 0;
                 float yPos = 0;
-                u32 rowOffset = 0;
-                uint8_t bmpColor = 0;
-                Color tmpColor(0);
-                
-                // Static glyph cache
-                static std::unordered_map<u64, Glyph> s_glyphCache; // may cause leak? will investigate later.
-                auto it = s_glyphCache.end();
-
-                float scaledFontSize;
+                u16* framebuffer = static_cast<u16*>(this->getCurrentFramebuffer());
 
                 // Loop through each character in the string
-                while (itStr != itStrEnd) {
+                for (const u32 currCharacter : run.codepoints) {
                     if (maxWidth > 0 && (currX - x) >= maxWidth)
                         break;
             
-                    // Decode UTF-8 codepoint
-                    codepointWidth = decode_utf8(&currCharacter, reinterpret_cast<const u8*>(&(*itStr)));
-                    if (codepointWidth <= 0)
-                        break;
-            
-                    // Move the iterator forward by the width of the current codepoint
-                    itStr += codepointWidth;
-            
                     if (currCharacter == '\n') {
                         maxX = std::max(currX, maxX);
                         currX = x;
@@ -3173,59 +5306,13 @@ namespace tsl {
                         continue;
                     }
             
-                    // Calculate glyph key
-                    key = (static_cast<u64>(currCharacter) << 32) | (static_cast<u64>(monospace) << 31) | (static_cast<u64>(std::bit_cast<u32>(fontSize)));
-            
-                    // Check cache for the glyph
-                    it = s_glyphCache.find(key);
-            
-                    // If glyph not found, create and cache it
-                    if (it == s_glyphCache.end()) {
-                        glyph = &s_glyphCache.emplace(key, Glyph()).first->second;
-            
-                        // Determine the appropriate font for the character
-                        if (stbtt_FindGlyphIndex(&this->m_extFont, currCharacter)) {
-                            glyph->currFont = &this->m_extFont;
-                        } else if (this->m_hasLocalFont && stbtt_FindGlyphIndex(&this->m_stdFont, currCharacter) == 0) {
-                            glyph->currFont = &this->m_localFont;
-                        } else {
-                            glyph->currFont = &this->m_stdFont;
-                        }
-            
-                        scaledFontSize = stbtt_ScaleForPixelHeight(glyph->currFont, fontSize);
-                        glyph->currFontSize = scaledFontSize;
-            
-                        // Get glyph bitmap and metrics
-                        stbtt_GetCodepointBitmapBoxSubpixel(glyph->currFont, currCharacter, scaledFontSize, scaledFontSize,
-                                                            0, 0, &glyph->bounds[0], &glyph->bounds[1], &glyph->bounds[2], &glyph->bounds[3]);
-            
-                        s32 yAdvance = 0;
-                        stbtt_GetCodepointHMetrics(glyph->currFont, monospace ? 'W' : currCharacter, &glyph->xAdvance, &yAdvance);
+                    glyph = this->getGlyph(currCharacter, monospace, fontSize);
             
-                        glyph->glyphBmp = stbtt_GetCodepointBitmap(glyph->currFont, scaledFontSize, scaledFontSize, currCharacter, &glyph->width, &glyph->height, nullptr, nullptr);
-                    } else {
-                        glyph = &it->second;
-                    }
-            
-                    if (glyph->glyphBmp != nullptr && !std::iswspace(currCharacter) && fontSize > 0 && color.a != 0x0) {
+                    if (!measureOnly && !glyph->coverage.empty() && !std::iswspace(currCharacter) && fontSize > 0) {
                         xPos = currX + glyph->bounds[0];
                         yPos = currY + glyph->bounds[1];
             
-                        // Optimized pixel processing
-                        for (s32 bmpY = 0; bmpY < glyph->height; ++bmpY) {
-                            rowOffset = bmpY * glyph->width;
-                            for (s32 bmpX = 0; bmpX < glyph->width; ++bmpX) {
-                                bmpColor = glyph->glyphBmp[rowOffset + bmpX] >> 4;
-                                if (bmpColor == 0xF) {
-                                    // Direct pixel manipulation
-                                    this->setPixel(xPos + bmpX, yPos + bmpY, color, this->getPixelOffset(xPos + bmpX, yPos + bmpY));
-                                } else if (bmpColor != 0x0) {
-                                    tmpColor = color;
-                                    tmpColor.a = bmpColor;
-                                    this->setPixelBlendDst(xPos + bmpX, yPos + bmpY, tmpColor);
-                                }
-                            }
-                        }
+                        this->blitGlyph(framebuffer, *glyph, static_cast<s32>(xPos), static_cast<s32>(yPos), color);
                     }
             
                     // Advance the cursor for the next glyph
@@ -3233,7 +5320,13 @@ namespace tsl {
                 }
             
                 maxX = std::max(currX, maxX);
-                return { static_cast<u32>(maxX - x), static_cast<u32>(currY - y) };
+                const std::pair<u32, u32> extent = { static_cast<u32>(maxX - x), static_cast<u32>(currY - y) };
+                if (maxWidth <= 0) {
+                    run.drawMeasured = true;
+                    run.drawWidth = extent.first;
+                    run.drawHeight = extent.second;
+                }
+                return extent;
             }
             
 
@@ -3241,6 +5334,164 @@ namespace tsl {
 
             
             
+            /**
+             * @brief Lays out a string as a \ref GlyphRun, skipped if it already holds that string and size
+             * @note Pen positions advance by the measured width of every single character, like drawing the
+             *       string one character at a time does
+             *
+             * @param run Run to fill
+             * @param text String to lay out
+             * @param x X pos of the first pen position
+             * @param fontSize Height of the text in pixels
+             */
+            inline void layoutGlyphRun(GlyphRun& run, const std::string& text, const float x, const s32 fontSize) {
+                if (run.fontSize == fontSize && run.text == text && !run.penX.empty() && run.penX.front() == x)
+                    return;
+
+                std::lock_guard<std::recursive_mutex> lock(this->m_textMutex);
+                auto glyphs = std::make_shared<std::vector<Glyph>>();
+                run.text = text;
+                run.fontSize = fontSize;
+                run.penX.clear();
+
+                float penX = x;
+                u32 codepoint;
+                ssize_t codepointWidth;
+                for (size_t pos = 0; pos < text.size(); pos += codepointWidth) {
+                    codepointWidth = decode_utf8(&codepoint, reinterpret_cast<const u8*>(text.data() + pos));
+                    if (codepointWidth <= 0)
+                        break;
+
+                    glyphs->push_back(*this->getGlyph(codepoint, false, fontSize));
+                    run.penX.push_back(penX);
+                    penX += this->calculateStringWidth(text.substr(pos, codepointWidth), fontSize);
+                }
+                run.glyphs = std::move(glyphs);
+                run.endX = penX;
+            }
+
+            /**
+             * @brief Draws a \ref GlyphRun with a color per glyph
+             * @note A recording list keeps the run's glyphs alive until the frame got rendered
+             *
+             * @param run Run laid out by \ref layoutGlyphRun
+             * @param y Y pos of the pen
+             * @param colorOf Callable taking the glyph index, returns the glyph's color
+             */
+            template<typename ColorOf>
+            inline void drawGlyphRun(const GlyphRun& run, const s32 y, ColorOf&& colorOf) {
+                if (run.glyphs == nullptr)
+                    return;
+
+                if (DisplayList* list = Renderer::s_recording)
+                    list->retain(run.glyphs);
+
+                for (size_t i = 0; i < run.glyphs->size(); ++i)
+                    this->drawGlyph((*run.glyphs)[i], static_cast<s32>(run.penX[i]), y, colorOf(i));
+            }
+
+            /**
+             * @brief Draws a single glyph, e.g. of a \ref GlyphRun
+             * @note The glyph has to stay valid until the frame got rendered, see \ref drawGlyphRun and \ref drawTextStrip
+             *
+             * @param glyph Glyph
+             * @param x X pos of the pen
+             * @param y Y pos of the pen
+             * @param color Glyph color
+             */
+            inline void drawGlyph(const Glyph& glyph, const s32 x, const s32 y, const Color& color) {
+                if (glyph.coverage.empty() || color.a == 0x0)
+                    return;
+
+                if (DisplayList* list = Renderer::s_recording) {
+                    list->add({ .type = DisplayList::CommandType::GlyphMask, .color = color.rgba, .x = x, .y = y, .data = &glyph });
+                    return;
+                }
+
+                this->blitGlyph(static_cast<u16*>(this->getCurrentFramebuffer()), glyph, x + glyph.bounds[0], y + glyph.bounds[1], color);
+            }
+
+            /**
+             * @brief Rasterizes a single line of text into one coverage mask, e.g. for scrolling text
+             * @note The strip is laid out like \ref drawTextRun draws it, so drawing it at a pen position gives the
+             *       same pixels as drawing the string there. Overlapping glyphs keep the higher coverage
+             *
+             * @param text Text, newlines are not supported
+             * @param fontSize Height of the text in pixels
+             * @return Strip with its offset from the pen position in bounds[0] and bounds[1]
+             */
+            inline std::shared_ptr<const Glyph> renderTextStrip(const std::string& text, const s32 fontSize) {
+                auto strip = std::make_shared<Glyph>();
+                if (text.empty() || fontSize <= 0)
+                    return strip;
+
+                std::lock_guard<std::recursive_mutex> lock(this->m_textMutex);
+                const std::vector<u32> codepoints = Renderer::s_textRuns.get(text, fontSize, false).codepoints;
+
+                // Glyph pointers only stay valid until the next lookup, so measure first and rasterize in a second pass
+                s32 x0 = INT32_MAX, y0 = INT32_MAX, x1 = INT32_MIN, y1 = INT32_MIN;
+                s32 penX = 0;
+                Glyph* glyph;
+                for (const u32 codepoint : codepoints) {
+                    glyph = this->getGlyph(codepoint, false, fontSize);
+                    if (!glyph->coverage.empty() && !std::iswspace(codepoint)) {
+                        x0 = std::min(x0, penX + glyph->bounds[0]);
+                        y0 = std::min(y0, glyph->bounds[1]);
+                        x1 = std::max(x1, penX + glyph->bounds[0] + glyph->width);
+                        y1 = std::max(y1, glyph->bounds[1] + glyph->height);
+                    }
+                    penX += static_cast<s32>(glyph->xAdvance * glyph->currFontSize);
+                }
+                if (x0 >= x1 || y0 >= y1)
+                    return strip;
+
+                strip->width = x1 - x0;
+                strip->height = y1 - y0;
+                strip->bounds[0] = x0;
+                strip->bounds[1] = y0;
+
+                std::vector<u8> bitmap(strip->width * strip->height, 0);
+                s32 stripX, stripY;
+                u8* row;
+                penX = 0;
+                for (const u32 codepoint : codepoints) {
+                    glyph = this->getGlyph(codepoint, false, fontSize);
+                    if (!glyph->coverage.empty() && !std::iswspace(codepoint)) {
+                        stripX = penX + glyph->bounds[0] - x0;
+                        stripY = glyph->bounds[1] - y0;
+                        for (s32 bmpY = 0; bmpY < glyph->height; ++bmpY) {
+                            row = bitmap.data() + (stripY + bmpY) * strip->width + stripX;
+                            for (s32 bmpX = 0; bmpX < glyph->width; ++bmpX)
+                                row[bmpX] = std::max<u8>(row[bmpX], glyph->getCoverage(bmpX, bmpY) << 4);
+                        }
+                    }
+                    penX += static_cast<s32>(glyph->xAdvance * glyph->currFontSize);
+                }
+
+                strip->packCoverage(bitmap.data());
+                return strip;
+            }
+
+            /**
+             * @brief Draws a strip made by \ref renderTextStrip
+             * @note Only the part inside the clip rect gets blended. A recording list keeps the strip alive
+             *       until the frame got rendered, so callers may drop it at any time
+             *
+             * @param strip Text strip
+             * @param x X pos of the pen
+             * @param y Y pos of the pen
+             * @param color Text color
+             */
+            inline void drawTextStrip(const std::shared_ptr<const Glyph>& strip, const s32 x, const s32 y, const Color& color) {
+                if (strip == nullptr)
+                    return;
+
+                if (DisplayList* list = Renderer::s_recording)
+                    list->retain(strip);
+
+                this->drawGlyph(*strip, x, y, color);
+            }
+
             inline void drawStringWithColoredSections(const std::string& text, const std::vector<std::string>& specialSymbols, s32 x, const s32 y, const u32 fontSize, const Color& defaultColor, const Color& specialColor) {
                 size_t startPos = 0;
                 size_t textLength = text.length();
@@ -3315,54 +5566,46 @@ namespace tsl {
                 if (string.size() < 2) {
                     return string;
                 }
-                
-                s32 currX = 0;
-                ssize_t strPos = 0;
-                ssize_t codepointWidth;
-                u32 ellipsisCharacter = 0x2026;  // Unicode code point for '…'
-                s32 ellipsisWidth;
-                
-                // Calculate the width of the ellipsis
-                stbtt_fontinfo* ellipsisFont = &this->m_stdFont;
-                if (stbtt_FindGlyphIndex(&this->m_extFont, ellipsisCharacter)) {
-                    ellipsisFont = &this->m_extFont;
-                } else if (this->m_hasLocalFont && stbtt_FindGlyphIndex(&this->m_stdFont, ellipsisCharacter) == 0) {
-                    ellipsisFont = &this->m_localFont;
-                }
-                float ellipsisFontSize = stbtt_ScaleForPixelHeight(ellipsisFont, fontSize);
-                int ellipsisXAdvance = 0, ellipsisYAdvance = 0;
-                stbtt_GetCodepointHMetrics(ellipsisFont, ellipsisCharacter, &ellipsisXAdvance, &ellipsisYAdvance);
-                ellipsisWidth = static_cast<s32>(ellipsisXAdvance * ellipsisFontSize);
-
-                u32 currCharacter;
-                std::string substr;
 
-                while (static_cast<std::string::size_type>(strPos) < string.size() && currX + ellipsisWidth < maxLength) {
-                    
-                    codepointWidth = decode_utf8(&currCharacter, reinterpret_cast<const u8*>(&string[strPos]));
-                    
-                    if (codepointWidth <= 0) {
-                        break;
-                    }
-                    
-                    // Calculate the width of the current substring plus the ellipsis
-                    substr = string.substr(0, strPos + codepointWidth);
-                    currX = calculateStringWidth(substr, fontSize, monospace);
-                    
-                    if (currX + ellipsisWidth >= maxLength) {
-                        return substr + "…";
+                // The cut only depends on the limit, so repeated queries are answered from the run
+                std::lock_guard<std::recursive_mutex> lock(this->m_textMutex);
+                TextRun& run = Renderer::s_textRuns.get(string, fontSize, monospace);
+                if (run.truncatedMaxLength != maxLength) {
+                    s32 currX = 0;
+
+                    // Calculate the width of the ellipsis
+                    const FontMetrics::CodepointMetrics ellipsis = this->m_fontMetrics.get(0x2026);  // Unicode code point for '…'
+                    const s32 ellipsisWidth = static_cast<s32>(ellipsis.xAdvance * this->m_fontMetrics.getScale(ellipsis.font, fontSize));
+
+                    if (run.prefixWidths.empty())
+                        this->measureTextRun(run);
+
+                    // Cut after the first codepoint whose prefix plus the ellipsis reaches the limit
+                    run.truncatedMaxLength = maxLength;
+                    run.truncatedBytes = std::string::npos;
+                    if (ellipsisWidth < maxLength) {
+                        for (size_t i = 0; i < run.codepoints.size(); ++i) {
+                            currX = static_cast<s32>(run.prefixWidths[i + 1]);
+                            if (currX + ellipsisWidth >= maxLength) {
+                                run.truncatedBytes = run.byteEnds[i];
+                                break;
+                            }
+                        }
                     }
-                    
-                    strPos += codepointWidth;
                 }
-                
-                return string;
+
+                if (run.truncatedBytes == std::string::npos)
+                    return string;
+
+                return string.substr(0, run.truncatedBytes) + "…";
             }
 
             
         private:
-            Renderer() {
-                updateDrawFunction();
+            Renderer() {}
+
+            ~Renderer() {
+                this->stopRenderThread();
             }
             
 
@@ -3379,6 +5622,8 @@ namespace tsl {
             
             /**
              * @brief Sets the opacity of the layer
+             * @note RGBA4444 only has 16 alpha levels, so the alpha table used by \ref a is only rebuilt
+             *       when the opacity crosses into another level
              *
              * @param opacity Opacity
              */
@@ -3386,23 +5631,149 @@ namespace tsl {
                 opacity = std::clamp(opacity, 0.0F, 1.0F);
                 
                 Renderer::s_opacity = opacity;
+
+                const u8 step = static_cast<u8>(0xF * opacity);
+                if (step == Renderer::s_opacityStep)
+                    return;
+
+                Renderer::s_opacityStep = step;
+                for (u8 alpha = 0; alpha < 16; ++alpha)
+                    Renderer::s_opacityAlpha[alpha] = std::min(alpha, step);
             }
             
             bool m_initialized = false;
+        #if USING_HEADLESS_DIRECTIVE
+            // In-memory stand-ins for the layer's framebuffers and its vsync, see init()
+            std::vector<u16> m_headlessFramebuffers;
+            u8 m_headlessSlot = 0;
+            u64 m_headlessVsyncNs = 0;
+            u64 m_headlessFrames = 0;
+            std::string m_headlessDumpDirectory;
+            bool m_headlessRealtime = false;
+        #else
             ViDisplay m_display;
             ViLayer m_layer;
             Event m_vsyncEvent;
             
             NWindow m_window;
             Framebuffer m_framebuffer;
+        #endif
             void *m_currentFramebuffer = nullptr;
             
             std::stack<ScissoringConfig> m_scissoringStack;
-            
+
+            // Pending repaint region per framebuffer slot. Each slot still holds the frame it showed last,
+            // so it has to catch up on everything that changed since then
+            static inline DamageRect s_slotDamage[4];
+            static inline bool s_damagePending = false;  // Damage reported since the last frame started repainting
+            static inline u32 s_damageSerial = 0;        // Counts damage reports, tells a retired frame whether it missed any
+            static inline std::mutex s_damageMutex;      // Slot damage is retired by the render thread
+            static inline u32 s_layerGeneration = 0;
+            DamageRect m_damage;        // Region repainted this frame
+            DamageRect m_clip;          // Layer, damage and scissor bounds combined
+            bool m_damageLatched = false;
+            u8 m_lastOpacityStep = 0xFF;
+            bool m_lastOpaqueColors = false;
+
+            // Render-ahead bookkeeping, see isRenderingAhead()
+            static constexpr u64 FramePeriodNs = 1'000'000'000ULL / 60;
+            u64 m_frameStartNs = 0;
+            u64 m_renderAheadSlackNs = 0;
+            RenderAheadStats m_renderAheadStats;
+
+            RasterWorkerPool m_rasterPool;
+
+            static inline GlyphAtlas s_glyphAtlas;
+            static inline TextRunCache s_textRuns;
+
+            // Background glyph rasterization, see prewarmGlyphs()
+            static constexpr s32 PrewarmFontSizes[] = { 23, 20, 16, 15 };
+            Thread m_prewarmThread;
+            bool m_prewarmThreadCreated = false;
+            std::atomic<bool> m_prewarmCancel = false;
+            std::vector<u32> m_prewarmCodepoints;
+            std::mutex m_prewarmMutex;
+            std::vector<std::pair<u64, Glyph>> m_prewarmedGlyphs;
+
             stbtt_fontinfo m_stdFont, m_localFont, m_extFont;
             bool m_hasLocalFont = false;
+            FontMetrics m_fontMetrics;
+            std::vector<u8> m_coverageRow;
+
+            /**
+             * @brief Blends a glyph's coverage into the framebuffer, clipped to the current clip rect
+             *
+             * @param framebuffer Framebuffer
+             * @param glyph Glyph
+             * @param glyphX X pos of the glyph's top left corner
+             * @param glyphY Y pos of the glyph's top left corner
+             * @param color Glyph color
+             */
+            inline void blitGlyph(u16* framebuffer, const Glyph& glyph, const s32 glyphX, const s32 glyphY, const Color& color) {
+                // Clip the glyph box once, so the pixel loop below never has to test bounds
+                const s32 bmpX0 = std::max(0, this->m_clip.x0 - glyphX);
+                const s32 bmpY0 = std::max(0, this->m_clip.y0 - glyphY);
+                const s32 bmpX1 = std::min(glyph.width, this->m_clip.x1 - glyphX);
+                const s32 bmpY1 = std::min(glyph.height, this->m_clip.y1 - glyphY);
+                if (bmpX0 >= bmpX1 || bmpY0 >= bmpY1)
+                    return;
+
+                // Blit whole glyph rows in aligned 8 column groups, which are contiguous in the block linear
+                // framebuffer. Lanes outside the clipped glyph get zero coverage and are left untouched
+                const s32 rowX0 = (glyphX + bmpX0) & ~7;
+                const s32 rowX1 = (glyphX + bmpX1 + 7) & ~7;
+                this->m_coverageRow.assign(rowX1 - rowX0, 0);
+
+                for (s32 bmpY = bmpY0; bmpY < bmpY1; ++bmpY) {
+                    for (s32 bmpX = bmpX0; bmpX < bmpX1; ++bmpX)
+                        this->m_coverageRow[glyphX + bmpX - rowX0] = glyph.getCoverage(bmpX, bmpY);
+
+                    for (s32 groupX = rowX0; groupX < rowX1; groupX += 8)
+                        blendRGBA4444Coverage(framebuffer + getBlockLinearOffset(groupX, glyphY + bmpY), this->m_coverageRow.data() + (groupX - rowX0), color, 8);
+                }
+            }
+            std::unordered_map<s32, std::vector<s32>> m_cornerMasks;
+            std::unordered_map<u16, std::vector<s32>> m_circleExtents;
+
+            // Text caches are shared by recording (measuring) and the render thread (drawing)
+            std::recursive_mutex m_textMutex;
+
+            // Display list recording, see renderFrame()
+            static inline thread_local DisplayList* s_recording = nullptr;
+            DisplayList m_displayLists[2];
+            u8 m_recordIndex = 0;
+            std::thread m_renderThread;
+            std::mutex m_renderMutex;
+            std::condition_variable m_renderCv;
+            DisplayList* m_pendingList = nullptr;
+            DisplayList* m_executingList = nullptr;
+            bool m_renderStopping = false;
             
             static inline float s_opacity = 1.0F;
+            static inline u8 s_opacityStep = 0xF;
+            static inline u8 s_opacityAlpha[16] = { 0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF };
+
+            // Blend tables of recently filled translucent colors, direct mapped by color, see getBlendTable()
+            static constexpr u32 BlendTableSlots = 32;
+            RGBA4444BlendTable m_blendTables[BlendTableSlots];
+            u32 m_blendTableColors[BlendTableSlots] = {};
+            
+            /**
+             * @brief Gets the blend tables of a color, building them on a miss
+             * @note A fade only produces 16 alpha levels per theme color, so those frames hit the cache as well
+             *
+             * @param color Fill color
+             * @return Blend tables, valid until the next call
+             */
+            inline const RGBA4444BlendTable& getBlendTable(const Color& color) {
+                // Colors are stored offset by one so the zeroed slots start out empty
+                const u32 slot = (color.rgba ^ (color.rgba >> 5) ^ (color.rgba >> 12)) & (BlendTableSlots - 1);
+                if (this->m_blendTableColors[slot] != color.rgba + 1U) {
+                    this->m_blendTables[slot] = RGBA4444BlendTable(color.r, color.g, color.b, color.a);
+                    this->m_blendTableColors[slot] = color.rgba + 1U;
+                }
+                return this->m_blendTables[slot];
+            }
             
             //u32 tmpPos;
             
@@ -3421,7 +5792,11 @@ namespace tsl {
              * @return Next framebuffer address
              */
             inline void* getNextFramebuffer() {
+            #if USING_HEADLESS_DIRECTIVE
+                return this->m_headlessFramebuffers.data() + this->getNextFramebufferSlot() * (this->getFramebufferSize() / sizeof(u16));
+            #else
                 return static_cast<u8*>(this->m_framebuffer.buf) + this->getNextFramebufferSlot() * this->getFramebufferSize();
+            #endif
             }
             
             /**
@@ -3430,7 +5805,12 @@ namespace tsl {
              * @return Framebuffer size
              */
             inline size_t getFramebufferSize() {
+            #if USING_HEADLESS_DIRECTIVE
+                // Block linear surfaces span whole 128 row blocks, like the ones framebufferCreate allocates
+                return cfg::FramebufferWidth * ((cfg::FramebufferHeight + 127) & ~127) * sizeof(u16);
+            #else
                 return this->m_framebuffer.fb_size;
+            #endif
             }
             
             /**
@@ -3439,7 +5819,11 @@ namespace tsl {
              * @return Number of framebuffers
              */
             inline size_t getFramebufferCount() {
+            #if USING_HEADLESS_DIRECTIVE
+                return framebufferCount;
+            #else
                 return this->m_framebuffer.num_fbs;
+            #endif
             }
             
             /**
@@ -3448,7 +5832,11 @@ namespace tsl {
              * @return Slot
              */
             inline u8 getCurrentFramebufferSlot() {
+            #if USING_HEADLESS_DIRECTIVE
+                return this->m_headlessSlot;
+            #else
                 return this->m_window.cur_slot;
+            #endif
             }
             
             /**
@@ -3456,56 +5844,385 @@ namespace tsl {
              *
              * @return Next slot
              */
-            inline u8 getNextFramebufferSlot() {
-                return (this->getCurrentFramebufferSlot() + 1) % this->getFramebufferCount();
+            inline u8 getNextFramebufferSlot() {
+                return (this->getCurrentFramebufferSlot() + 1) % this->getFramebufferCount();
+            }
+            
+            /**
+             * @brief Waits for the vsync event
+             *
+             */
+            inline void waitForVSync() {
+            #if USING_HEADLESS_DIRECTIVE
+                // Simulated 60 Hz display: the next vblank after now, slept for only when running in real time
+                const u64 nowNs = hlp::getTimeNs();
+                this->m_headlessVsyncNs = std::max(this->m_headlessVsyncNs, nowNs - nowNs % Renderer::FramePeriodNs) + Renderer::FramePeriodNs;
+                if (this->m_headlessRealtime && this->m_headlessVsyncNs > nowNs)
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(this->m_headlessVsyncNs - nowNs));
+            #else
+                eventWait(&this->m_vsyncEvent, UINT64_MAX);
+            #endif
+            }
+
+            /**
+             * @brief Decodes a x and y coordinate into a offset into the swizzled framebuffer
+             *
+             * @param x X pos
+             * @param y Y Pos
+             * @return Offset
+             */
+            inline u32 getPixelOffset(const s32 x, const s32 y) {
+                // Check for scissoring and damage boundaries
+                if (x < this->m_clip.x0 || y < this->m_clip.y0 || x >= this->m_clip.x1 || y >= this->m_clip.y1)
+                    return UINT32_MAX;
+
+                // Calculate the base offset
+                //tmpPos = (((y & 127) / 16) + ((x / 32) * 8) + ((y / 128) * (cfg::FramebufferWidth / 4)))*1024;
+                return getBlockLinearOffset(x, y);
+                //tmpPos *= 1024; // 16 * 16 * 4 = 1024
+            
+                // Calculate the fine offset and add it to the base offset
+                //tmpPos += ((y % 16) / 8) * 512 + 
+                //          ((x % 32) / 16) * 256 + 
+                //          ((y % 8) / 2) * 64 + 
+                //          ((x % 16) / 8) * 32 + 
+                //          (y % 2) * 16 + 
+                //          (x % 8) * 2;
+            
+                //return tmpPos;
+            }
+
+            /**
+             * @brief Gets the bounds of the whole layer
+             *
+             * @return Layer rect
+             */
+            inline static DamageRect getLayerRect() {
+                return { 0, 0, static_cast<s32>(cfg::FramebufferWidth), static_cast<s32>(cfg::FramebufferHeight) };
+            }
+
+            /**
+             * @brief Accounts a frame's render time against the time banked by running ahead
+             * @note A frame over the vsync period would have been dropped with two framebuffers. It is absorbed when
+             *       the frames before it finished early enough to bank that overrun, capped at the one spare framebuffer
+             *
+             * @param renderNs Time from \ref startFrame to \ref endFrame
+             */
+            inline void updateRenderAheadStats(const u64 renderNs) {
+                this->m_renderAheadStats.frames++;
+                if (renderNs <= Renderer::FramePeriodNs) {
+                    this->m_renderAheadSlackNs = std::min(Renderer::FramePeriodNs, this->m_renderAheadSlackNs + (Renderer::FramePeriodNs - renderNs));
+                    return;
+                }
+
+                const u64 overrunNs = renderNs - Renderer::FramePeriodNs;
+                this->m_renderAheadStats.framesOverBudget++;
+                if (this->m_renderAheadSlackNs >= overrunNs) {
+                    this->m_renderAheadSlackNs -= overrunNs;
+                    this->m_renderAheadStats.framesSaved++;
+                } else {
+                    this->m_renderAheadSlackNs = 0;
+                }
+            }
+
+            /**
+             * @brief Takes over the pending damage of the current framebuffer slot as this frame's repaint region
+             * @note Called by the first background clear of a frame. Damage reported up to this point is part of the frame.
+             */
+            inline void latchDamage() {
+                std::lock_guard<std::mutex> lock(Renderer::s_damageMutex);
+
+                // A recorded frame does not know yet which slot it lands in, so it repaints what any slot is missing.
+                // The render thread clears the damage of the slot it actually dequeued, see retireSlotDamage()
+                if (DisplayList* list = Renderer::s_recording) {
+                    if (list->damageLatched)
+                        return;
+
+                    list->damage = {};
+                    for (const auto& slotDamage : Renderer::s_slotDamage)
+                        list->damage.merge(slotDamage);
+                    list->damageSerial = Renderer::s_damageSerial;
+                    list->damageLatched = true;
+                    Renderer::s_damagePending = false;
+                    list->add({ .type = DisplayList::CommandType::LatchDamage });
+                    return;
+                }
+
+                if (this->m_damageLatched)
+                    return;
+
+                DamageRect& slotDamage = Renderer::s_slotDamage[this->getCurrentFramebufferSlot() % std::size(Renderer::s_slotDamage)];
+                this->m_damage = slotDamage;
+                slotDamage = {};
+                this->m_damageLatched = true;
+                Renderer::s_damagePending = false;
+                this->updateClip();
+            }
+
+            /**
+             * @brief Marks the current framebuffer slot as caught up after a recorded frame got executed into it
+             * @note Damage reported after the frame got latched stays pending, the frame was recorded without it.
+             *       The slot then gets over-painted by a later frame, which is cheaper than tracking exact regions
+             *
+             * @param list Executed display list
+             */
+            inline void retireSlotDamage(const DisplayList& list) {
+                if (!list.damageLatched)
+                    return;
+
+                std::lock_guard<std::mutex> lock(Renderer::s_damageMutex);
+                if (Renderer::s_damageSerial == list.damageSerial)
+                    Renderer::s_slotDamage[this->getCurrentFramebufferSlot() % std::size(Renderer::s_slotDamage)] = {};
+            }
+
+            /**
+             * @brief Invalidates the whole layer if the opacity level or transparency mode changed
+             * @note Every color goes through a(), so such a change affects every pixel. Fade frames that stay on
+             *       the same one of the 16 alpha levels produce the same pixels and are skipped
+             */
+            inline void checkColorDamage() {
+                const bool opaqueColors = disableTransparency && useOpaqueScreenshots;
+                if (Renderer::s_opacityStep != this->m_lastOpacityStep || opaqueColors != this->m_lastOpaqueColors) {
+                    this->m_lastOpacityStep = Renderer::s_opacityStep;
+                    this->m_lastOpaqueColors = opaqueColors;
+                    Renderer::invalidateAll();
+                }
+            }
+
+            /**
+             * @brief Checks if anything changed since the last frame
+             * @note When this returns false the frame can be skipped entirely, the screen already shows the current state
+             *
+             * @return true if a new frame has to be drawn
+             */
+            inline bool hasPendingDamage() {
+                this->checkColorDamage();
+                return Renderer::s_damagePending;
+            }
+
+            /**
+             * @brief Checks if this frame repaints the whole layer
+             *
+             * @return true if the damaged area covers the layer
+             */
+            inline bool isFullFrameDamage() const {
+                return !this->m_damageLatched ||
+                       (this->m_damage.x0 <= 0 && this->m_damage.y0 <= 0 &&
+                        this->m_damage.x1 >= static_cast<s32>(cfg::FramebufferWidth) && this->m_damage.y1 >= static_cast<s32>(cfg::FramebufferHeight));
+            }
+
+            /**
+             * @brief Recomputes the effective clip rect from the layer, the damaged area and the top scissor rect
+             */
+            inline void updateClip() {
+                this->m_clip = this->m_damageLatched ? this->m_damage : Renderer::getLayerRect();
+                this->m_clip.intersect(Renderer::getLayerRect());
+
+                if (!this->m_scissoringStack.empty()) {
+                    const auto& currScissorConfig = this->m_scissoringStack.top();
+                    this->m_clip.intersect({ currScissorConfig.x, currScissorConfig.y, currScissorConfig.x + currScissorConfig.w, currScissorConfig.y + currScissorConfig.h });
+                }
+            }
+
+            /**
+             * @brief Calls func(x, y, count) for every run of the damaged area that is contiguous in the framebuffer
+             *
+             * @param func Callback
+             */
+            template<typename Func>
+            inline void forEachDamagedRun(Func&& func) {
+                Renderer::forEachRun(this->m_damage, func);
+            }
+
+            /**
+             * @brief Calls func(x, y, count) for every run of a region that is contiguous in the framebuffer
+             * @note Runs never cross an aligned group of 8 columns, which is contiguous in the block-linear layout
+             *
+             * @param region Region, gets clipped to the layer
+             * @param func Callback
+             */
+            template<typename Func>
+            inline static void forEachRun(DamageRect region, Func&& func) {
+                region.intersect(Renderer::getLayerRect());
+                if (region.empty())
+                    return;
+
+                s32 runStart, runEnd;
+                for (s32 y = region.y0; y < region.y1; ++y) {
+                    for (runStart = region.x0; runStart < region.x1; runStart = runEnd) {
+                        runEnd = std::min((runStart & ~7) + 8, region.x1);
+                        func(runStart, y, runEnd - runStart);
+                    }
+                }
+            }
+
+            /**
+             * @brief Fills in the prefix widths of a text run
+             * @note Runs the former calculateStringWidth pass once, recording the width after every codepoint
+             *
+             * @param run Text run, its monospace flag selects fixed width numbers
+             */
+            inline void measureTextRun(TextRun& run) {
+                const s32 fontSize = run.fontSize;
+                const bool fixedWidthNumbers = run.monospace;
+
+                float totalWidth = 0.0f;
+                u32 prevCharacter = 0;
+                float currFontSize;
+                FontMetrics::CodepointMetrics metrics;
+
+                // Cache default width for numeric characters if fixedWidthNumbers is true
+                const float numericCharWidth = fixedWidthNumbers ? defaultNumericCharWidth * fontSize : 0.0f;
+
+                run.prefixWidths.clear();
+                run.prefixWidths.reserve(run.codepoints.size() + 1);
+                run.prefixWidths.push_back(0.0f);
+
+                for (const u32 currCharacter : run.codepoints) {
+                    if (fixedWidthNumbers && std::isdigit(currCharacter)) {
+                        totalWidth += numericCharWidth;
+                    } else {
+                        metrics = this->m_fontMetrics.get(currCharacter);
+                        if (metrics.widthFactor >= 0.0f) {
+                            // Fixed width from characterWidths
+                            totalWidth += metrics.widthFactor * fontSize;
+                        } else {
+                            currFontSize = this->m_fontMetrics.getScale(metrics.font, fontSize);
+
+                            if (prevCharacter) {
+                                totalWidth += this->m_fontMetrics.getKernAdvance(metrics.font, prevCharacter, currCharacter) * currFontSize;
+                            }
+
+                            totalWidth += metrics.xAdvance * currFontSize;
+                        }
+                    }
+
+                    run.prefixWidths.push_back(totalWidth);
+                    prevCharacter = currCharacter;
+                }
+            }
+
+            /**
+             * @brief Builds the atlas key of a glyph
+             */
+            inline static u64 getGlyphKey(const u32 codepoint, const bool monospace, const s32 fontSize) {
+                return (static_cast<u64>(codepoint) << 32) | (static_cast<u64>(monospace) << 31) | (static_cast<u64>(std::bit_cast<u32>(fontSize)));
+            }
+
+            /**
+             * @brief Rasterizes a glyph and packs its coverage
+             * @note Only reads the font data, so it is safe to call from the prewarm thread
+             *
+             * @param codepoint Unicode codepoint
+             * @param monospace Use the monospace advance
+             * @param fontSize Height of the text in pixels
+             * @return Rasterized glyph
+             */
+            inline Glyph rasterizeGlyph(const u32 codepoint, const bool monospace, const s32 fontSize) {
+                Glyph glyph;
+
+                // Determine the appropriate font for the character
+                glyph.currFont = this->m_fontMetrics.getFont(this->m_fontMetrics.resolveFont(codepoint));
+
+                const float scaledFontSize = stbtt_ScaleForPixelHeight(glyph.currFont, fontSize);
+                glyph.currFontSize = scaledFontSize;
+
+                // Get glyph bitmap and metrics
+                stbtt_GetCodepointBitmapBoxSubpixel(glyph.currFont, codepoint, scaledFontSize, scaledFontSize,
+                                                    0, 0, &glyph.bounds[0], &glyph.bounds[1], &glyph.bounds[2], &glyph.bounds[3]);
+
+                s32 yAdvance = 0;
+                stbtt_GetCodepointHMetrics(glyph.currFont, monospace ? 'W' : codepoint, &glyph.xAdvance, &yAdvance);
+
+                // Keep only the packed coverage, the 8 bit bitmap is freed right away
+                u8* bitmap = stbtt_GetCodepointBitmap(glyph.currFont, scaledFontSize, scaledFontSize, codepoint, &glyph.width, &glyph.height, nullptr, nullptr);
+                if (bitmap != nullptr) {
+                    glyph.packCoverage(bitmap);
+                    stbtt_FreeBitmap(bitmap, nullptr);
+                } else {
+                    glyph.width = glyph.height = 0;
+                }
+
+                return glyph;
             }
-            
+
             /**
-             * @brief Waits for the vsync event
-             *
+             * @brief Moves glyphs finished by the prewarm thread into the atlas
+             * @note Never blocks, whatever is not ready yet gets picked up by a later frame
              */
-            inline void waitForVSync() {
-                eventWait(&this->m_vsyncEvent, UINT64_MAX);
+            inline void adoptPrewarmedGlyphs() {
+                std::unique_lock<std::mutex> lock(this->m_prewarmMutex, std::try_to_lock);
+                if (!lock.owns_lock() || this->m_prewarmedGlyphs.empty())
+                    return;
+
+                std::unique_lock<std::recursive_mutex> textLock(this->m_textMutex, std::try_to_lock);
+                if (!textLock.owns_lock())
+                    return;
+
+                for (auto& [key, glyph] : this->m_prewarmedGlyphs) {
+                    if (!Renderer::s_glyphAtlas.contains(key))
+                        Renderer::s_glyphAtlas.insert(key, std::move(glyph));
+                }
+                this->m_prewarmedGlyphs.clear();
             }
-            
+
+            static void prewarmThreadFunc(void* arg) {
+                Renderer* self = static_cast<Renderer*>(arg);
+                const size_t budget = glyphAtlasBudget / 2;
+                size_t usedBytes = 0;
+                Glyph glyph;
+
+                for (const s32 fontSize : PrewarmFontSizes) {
+                    for (const u32 codepoint : self->m_prewarmCodepoints) {
+                        if (self->m_prewarmCancel.load(std::memory_order_relaxed) || usedBytes >= budget)
+                            return;
+
+                        glyph = self->rasterizeGlyph(codepoint, false, fontSize);
+                        usedBytes += sizeof(Glyph) + glyph.coverage.capacity();
+
+                        std::lock_guard<std::mutex> lock(self->m_prewarmMutex);
+                        self->m_prewarmedGlyphs.emplace_back(getGlyphKey(codepoint, false, fontSize), std::move(glyph));
+                    }
+                }
+            }
+
             /**
-             * @brief Decodes a x and y coordinate into a offset into the swizzled framebuffer
+             * @brief Calls func(offset, count) for every span of a region that is contiguous in the framebuffer
+             * @note Walks the region one 32 pixel tile column at a time. Fully covered 32x16 tiles are 512 contiguous
+             *       pixels and stack up to a whole 128 row block, the ragged edges fall back to runs of 8 columns.
              *
-             * @param x X pos
-             * @param y Y Pos
-             * @return Offset
+             * @param region Region, gets clipped to the layer
+             * @param func Callback
              */
-            inline u32 getPixelOffset(const s32 x, const s32 y) {
-                // Check for scissoring boundaries
-                if (!this->m_scissoringStack.empty()) {
-                    const auto& currScissorConfig = this->m_scissoringStack.top();
-                    if (x < currScissorConfig.x || y < currScissorConfig.y || 
-                        x >= currScissorConfig.x + currScissorConfig.w || 
-                        y >= currScissorConfig.y + currScissorConfig.h) {
-                        return UINT32_MAX;
+            template<typename Func>
+            inline static void forEachSpan(DamageRect region, Func&& func) {
+                region.intersect(Renderer::getLayerRect());
+                if (region.empty())
+                    return;
+
+                const s32 alignedY1 = region.y1 & ~15;
+                s32 tileX, spanX0, spanX1, y, spanEnd, runStart, runEnd;
+                bool fullWidth;
+                for (tileX = region.x0 & ~31; tileX < region.x1; tileX += 32) {
+                    spanX0 = std::max(region.x0, tileX);
+                    spanX1 = std::min(region.x1, tileX + 32);
+                    fullWidth = (spanX1 - spanX0) == 32;
+
+                    for (y = region.y0; y < region.y1;) {
+                        if (fullWidth && (y & 15) == 0 && y < alignedY1) {
+                            spanEnd = std::min(alignedY1, (y & ~127) + 128);
+                            func(getBlockLinearOffset(tileX, y), static_cast<u32>(spanEnd - y) * 32);
+                            y = spanEnd;
+                            continue;
+                        }
+
+                        for (runStart = spanX0; runStart < spanX1; runStart = runEnd) {
+                            runEnd = std::min((runStart & ~7) + 8, spanX1);
+                            func(getBlockLinearOffset(runStart, y), static_cast<u32>(runEnd - runStart));
+                        }
+                        ++y;
                     }
                 }
-            
-                // Calculate the base offset
-                //tmpPos = (((y & 127) / 16) + ((x / 32) * 8) + ((y / 128) * (cfg::FramebufferWidth / 4)))*1024;
-                return (((y & 127) / 16) + ((x / 32) * 8) + ((y / 128) * 112))*512 +
-                        ((y % 16) / 8) * 256 + 
-                        ((x % 32) / 16) * 128 + 
-                        ((y % 8) / 2) * 32 + 
-                        ((x % 16) / 8) * 16 + 
-                        (y % 2) * 8 + 
-                        (x % 8);
-                //tmpPos *= 1024; // 16 * 16 * 4 = 1024
-            
-                // Calculate the fine offset and add it to the base offset
-                //tmpPos += ((y % 16) / 8) * 512 + 
-                //          ((x % 32) / 16) * 256 + 
-                //          ((y % 8) / 2) * 64 + 
-                //          ((x % 16) / 8) * 32 + 
-                //          (y % 2) * 16 + 
-                //          (x % 8) * 2;
-            
-                //return tmpPos;
             }
 
             
@@ -3529,6 +6246,13 @@ namespace tsl {
                 if (this->m_initialized)
                     return;
                 
+            #if USING_HEADLESS_DIRECTIVE
+                // No vi layer on the host, frames go into plain memory in the same block linear layout
+                this->m_headlessFramebuffers.assign(framebufferCount * this->getFramebufferSize() / sizeof(u16), 0);
+                this->m_headlessSlot = 0;
+                this->m_headlessFrames = 0;
+                ASSERT_FATAL(this->initFonts());
+            #else
                 tsl::hlp::doWithSmSession([this]{
                     ASSERT_FATAL(viInitialize(ViServiceType_Manager));
                     ASSERT_FATAL(viOpenDefaultDisplay(&this->m_display));
@@ -3553,12 +6277,21 @@ namespace tsl {
                     ASSERT_FATAL(viSetLayerSize(&this->m_layer, cfg::LayerWidth, cfg::LayerHeight));
                     ASSERT_FATAL(viSetLayerPosition(&this->m_layer, cfg::LayerPosX, cfg::LayerPosY));
                     ASSERT_FATAL(nwindowCreateFromLayer(&this->m_window, &this->m_layer));
-                    ASSERT_FATAL(framebufferCreate(&this->m_framebuffer, &this->m_window, cfg::FramebufferWidth, cfg::FramebufferHeight, PIXEL_FORMAT_RGBA_4444, 2));
+                    ASSERT_FATAL(framebufferCreate(&this->m_framebuffer, &this->m_window, cfg::FramebufferWidth, cfg::FramebufferHeight, PIXEL_FORMAT_RGBA_4444, framebufferCount));
                     ASSERT_FATAL(setInitialize());
                     ASSERT_FATAL(this->initFonts());
                     setExit();
                 });
-                
+            #endif
+
+                // Spawn the raster workers once for the lifetime of the renderer
+                this->m_rasterPool.start(numThreads);
+                if (useRenderThread)
+                    this->startRenderThread();
+
+                Renderer::s_glyphAtlas.setBudget(glyphAtlasBudget);
+                Renderer::s_textRuns.setCapacity(textRunCacheCapacity);
+
                 this->m_initialized = true;
             }
             
@@ -3569,14 +6302,106 @@ namespace tsl {
             void exit() {
                 if (!this->m_initialized)
                     return;
-                
+
+                this->stopRenderThread();
+                this->m_rasterPool.stop();
+                FrameProfiler::flush();
+                this->cancelGlyphPrewarm();
+                this->m_prewarmedGlyphs.clear();
+                Renderer::s_glyphAtlas.clear();
+                Renderer::s_textRuns.clear();
+
+                #if USING_LOGGING_DIRECTIVE
+                if (this->isRenderingAhead())
+                    logMessage("Renderer: render-ahead absorbed " + std::to_string(this->m_renderAheadStats.framesSaved) + " of " +
+                        std::to_string(this->m_renderAheadStats.framesOverBudget) + " frames over budget in " +
+                        std::to_string(this->m_renderAheadStats.frames) + " frames");
+                #endif
+
+            #if USING_HEADLESS_DIRECTIVE
+                this->m_headlessFramebuffers.clear();
+            #else
                 framebufferClose(&this->m_framebuffer);
                 nwindowClose(&this->m_window);
                 viDestroyManagedLayer(&this->m_layer);
                 viCloseDisplay(&this->m_display);
                 eventClose(&this->m_vsyncEvent);
                 viExit();
+            #endif
+            }
+
+        #if USING_HEADLESS_DIRECTIVE
+            /**
+             * @brief Makes the headless backend write every presented frame into a directory
+             * @note Frames are named frame_00000.png and so on
+             *
+             * @param directory Destination directory, empty to stop dumping
+             */
+            inline void setFrameDumpDirectory(const std::string& directory) {
+                this->m_headlessDumpDirectory = directory;
+            }
+
+            /**
+             * @brief Makes the simulated vsync sleep like a real display instead of only advancing its clock
+             *
+             * @param realtime Pace frames at 60 Hz
+             */
+            inline void setHeadlessRealtime(const bool realtime) {
+                this->m_headlessRealtime = realtime;
+            }
+
+            /**
+             * @brief Gets the number of frames presented by the headless backend
+             *
+             * @return Frame count
+             */
+            inline u64 getHeadlessFrameCount() const {
+                return this->m_headlessFrames;
+            }
+
+            /**
+             * @brief Gets the framebuffer that got presented last
+             *
+             * @return Block linear RGBA4444 pixels
+             */
+            inline const u16* getPresentedFramebuffer() {
+                const size_t slot = (this->m_headlessSlot + framebufferCount - 1) % framebufferCount;
+                return this->m_headlessFramebuffers.data() + slot * (this->getFramebufferSize() / sizeof(u16));
+            }
+
+            /**
+             * @brief Writes a block linear RGBA4444 frame to a file
+             *
+             * @param framebuffer Frame, e.g. \ref getPresentedFramebuffer
+             * @param path Destination file
+             * @param raw Write the block linear RGBA4444 data as is instead of a PNG
+             * @return true on success
+             */
+            static bool dumpFrame(const u16* framebuffer, const std::string& path, const bool raw = false) {
+                const size_t pixelCount = cfg::FramebufferWidth * ((cfg::FramebufferHeight + 127) & ~127);
+                if (raw) {
+                    FILE* file = fopen(path.c_str(), "wb");
+                    if (file == nullptr)
+                        return false;
+                    const bool written = fwrite(framebuffer, sizeof(u16), pixelCount, file) == pixelCount;
+                    fclose(file);
+                    return written;
+                }
+
+                // Linearize and expand every nibble to 8 bits
+                std::vector<u8> rgba(cfg::FramebufferWidth * cfg::FramebufferHeight * 4);
+                u8* pixel = rgba.data();
+                u16 value;
+                for (s32 y = 0; y < cfg::FramebufferHeight; ++y) {
+                    for (s32 x = 0; x < cfg::FramebufferWidth; ++x, pixel += 4) {
+                        value = framebuffer[getBlockLinearOffset(x, y)];
+                        for (u8 channel = 0; channel < 4; ++channel)
+                            pixel[channel] = ((value >> (channel * 4)) & 0xF) * 0x11;
+                    }
+                }
+                return writePNG(path, cfg::FramebufferWidth, cfg::FramebufferHeight, rgba.data());
             }
+        #endif
             
             /**
              * @brief Initializes Nintendo's shared fonts. Default and Extended
@@ -3584,6 +6409,32 @@ namespace tsl {
              * @return Result
              */
             Result initFonts() {
+            #if USING_HEADLESS_DIRECTIVE
+                // The shared fonts come from files on the host, the extended icon font falls back to the standard one
+                static std::vector<u8> stdFontFile, extFontFile;
+                const auto readFont = [](const char* path, std::vector<u8>& data) {
+                    FILE* file = (path != nullptr) ? fopen(path, "rb") : nullptr;
+                    if (file == nullptr)
+                        return false;
+                    fseek(file, 0, SEEK_END);
+                    data.resize(ftell(file));
+                    fseek(file, 0, SEEK_SET);
+                    const bool read = fread(data.data(), 1, data.size(), file) == data.size();
+                    fclose(file);
+                    return read && !data.empty();
+                };
+
+                if (!readFont(std::getenv("TESLA_HEADLESS_FONT"), stdFontFile))
+                    return 1;
+                if (!readFont(std::getenv("TESLA_HEADLESS_EXT_FONT"), extFontFile))
+                    extFontFile = stdFontFile;
+
+                stbtt_InitFont(&this->m_stdFont, stdFontFile.data(), stbtt_GetFontOffsetForIndex(stdFontFile.data(), 0));
+                stbtt_InitFont(&this->m_extFont, extFontFile.data(), stbtt_GetFontOffsetForIndex(extFontFile.data(), 0));
+                this->m_hasLocalFont = false;
+                this->m_fontMetrics.setFonts(&this->m_stdFont, &this->m_localFont, &this->m_extFont, this->m_hasLocalFont);
+                return 0;
+            #else
                 static PlFontData stdFontData, localFontData, extFontData;
                 
                 // Nintendo's default font
@@ -3615,39 +6466,400 @@ namespace tsl {
                         break;
                     }
                     
-                    if (this->m_hasLocalFont) {
-                        fontBuffer = reinterpret_cast<u8*>(localFontData.address);
-                        stbtt_InitFont(&this->m_localFont, fontBuffer, stbtt_GetFontOffsetForIndex(fontBuffer, 0));
-                    }
+                    if (this->m_hasLocalFont) {
+                        fontBuffer = reinterpret_cast<u8*>(localFontData.address);
+                        stbtt_InitFont(&this->m_localFont, fontBuffer, stbtt_GetFontOffsetForIndex(fontBuffer, 0));
+                    }
+                }
+                
+                // Nintendo's extended font containing a bunch of icons
+                TSL_R_TRY(plGetSharedFontByType(&extFontData, PlSharedFontType_NintendoExt));
+                
+                fontBuffer = reinterpret_cast<u8*>(extFontData.address);
+                stbtt_InitFont(&this->m_extFont, fontBuffer, stbtt_GetFontOffsetForIndex(fontBuffer, 0));
+
+                this->m_fontMetrics.setFonts(&this->m_stdFont, &this->m_localFont, &this->m_extFont, this->m_hasLocalFont);
+                
+                return 0;
+            #endif
+            }
+
+            /**
+             * @brief Dequeues the next framebuffer
+             * @note With a spare framebuffer this only blocks once rendering is a full frame ahead of the display
+             */
+            inline void beginFramebuffer() {
+            #if USING_HEADLESS_DIRECTIVE
+                this->m_currentFramebuffer = this->m_headlessFramebuffers.data() + this->m_headlessSlot * (this->getFramebufferSize() / sizeof(u16));
+            #else
+                this->m_currentFramebuffer = framebufferBegin(&this->m_framebuffer, nullptr);
+            #endif
+                this->m_frameStartNs = hlp::getTimeNs();
+            }
+
+            /**
+             * @brief Clears the whole layer to transparent, independent of the damaged area
+             */
+            inline void clearLayer() {
+                this->m_damage = Renderer::getLayerRect();
+                this->m_damageLatched = true;
+                this->updateClip();
+
+                this->fillScreen({ 0x00, 0x00, 0x00, 0x00 });
+            }
+
+            static void renderThreadFunc(Renderer* self) {
+                DisplayList* list;
+
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(self->m_renderMutex);
+                        self->m_renderCv.wait(lock, [self] { return self->m_renderStopping || self->m_pendingList != nullptr; });
+                        if (self->m_pendingList == nullptr)
+                            return;
+
+                        list = self->m_pendingList;
+                        self->m_executingList = list;
+                        self->m_pendingList = nullptr;
+                    }
+                    self->m_renderCv.notify_all();
+
+                    self->beginFramebuffer();
+                    if (useFrameProfiler) {
+                        const u64 rasterStartNs = hlp::getTimeNs();
+                        self->executeDisplayList(*list);
+                        FrameProfiler::addStage(FrameProfiler::Stage::Raster, hlp::getTimeNs() - rasterStartNs);
+                    } else {
+                        self->executeDisplayList(*list);
+                    }
+                    self->retireSlotDamage(*list);
+                    self->endFrame();
+
+                    {
+                        std::lock_guard<std::mutex> lock(self->m_renderMutex);
+                        self->m_executingList = nullptr;
+                    }
+                    self->m_renderCv.notify_all();
+                }
+            }
+            
+            /**
+             * @brief Start a new frame
+             * @warning Don't call this more than once before calling \ref endFrame
+             */
+            inline void startFrame() {
+                this->beginFramebuffer();
+
+                this->adoptPrewarmedGlyphs();
+                this->checkColorDamage();
+                this->m_damageLatched = false;
+                this->updateClip();
+            }
+            
+            /**
+             * @brief End the current frame
+             * @warning Don't call this before calling \ref startFrame once
+             */
+            inline void endFrame() {
+                const u64 endFrameStartNs = useFrameProfiler ? hlp::getTimeNs() : 0;
+                if (this->isRenderingAhead())
+                    this->updateRenderAheadStats(hlp::getTimeNs() - this->m_frameStartNs);
+                else
+                    this->waitForVSync();
+            #if USING_HEADLESS_DIRECTIVE
+                if (!this->m_headlessDumpDirectory.empty()) {
+                    char name[32];
+                    snprintf(name, sizeof(name), "/frame_%05llu", static_cast<unsigned long long>(this->m_headlessFrames));
+                    Renderer::dumpFrame(static_cast<const u16*>(this->m_currentFramebuffer), this->m_headlessDumpDirectory + name + ".png");
+                }
+                this->m_headlessSlot = (this->m_headlessSlot + 1) % framebufferCount;
+                this->m_headlessFrames++;
+            #else
+                framebufferEnd(&this->m_framebuffer);
+            #endif
+                if (useFrameProfiler)
+                    FrameProfiler::addStage(FrameProfiler::Stage::EndFrame, hlp::getTimeNs() - endFrameStartNs);
+                
+                this->m_currentFramebuffer = nullptr;
+            }
+
+            /**
+             * @brief Checks if a third framebuffer lets rendering run ahead of the display
+             * @note Frames are then paced by the buffer queue instead of waiting for vsync in \ref endFrame
+             *
+             * @return true when triple buffered
+             */
+            inline bool isRenderingAhead() {
+                return this->getFramebufferCount() > 2;
+            }
+
+            /**
+             * @brief Gets the render-ahead counters
+             *
+             * @return Render-ahead stats
+             */
+            inline const RenderAheadStats& getRenderAheadStats() const {
+                return this->m_renderAheadStats;
+            }
+
+            /**
+             * @brief Draws one frame, through a display list on the render thread when that one runs
+             *
+             * @param draw Callable taking the renderer, draws the frame
+             */
+            template<typename Draw>
+            inline void renderFrame(Draw&& draw) {
+                if (!this->isRenderThreadRunning()) {
+                    this->startFrame();
+                    draw(this);
+                    this->endFrame();
+                    return;
+                }
+
+                DisplayList& list = this->acquireDisplayList();
+                this->beginRecording(list);
+                draw(this);
+                this->endRecording();
+                this->submitDisplayList(list);
+            }
+
+            /**
+             * @brief Checks if frames are recorded and rasterized on the render thread
+             *
+             * @return true if the render thread runs
+             */
+            inline bool isRenderThreadRunning() const {
+                return this->m_renderThread.joinable();
+            }
+
+            /**
+             * @brief Blocks until the render thread executed every submitted frame
+             */
+            inline void waitForRenderThread() {
+                std::unique_lock<std::mutex> lock(this->m_renderMutex);
+                this->m_renderCv.wait(lock, [this] { return this->m_pendingList == nullptr && this->m_executingList == nullptr; });
+            }
+
+            /**
+             * @brief Starts the render thread
+             * @note From then on frame N gets rasterized while the main thread records frame N + 1
+             */
+            inline void startRenderThread() {
+                if (this->isRenderThreadRunning())
+                    return;
+
+                this->m_renderStopping = false;
+                Renderer::invalidateAll();
+                this->m_renderThread = std::thread(&Renderer::renderThreadFunc, this);
+            }
+
+            /**
+             * @brief Executes what is still queued and joins the render thread
+             */
+            inline void stopRenderThread() {
+                if (!this->isRenderThreadRunning())
+                    return;
+
+                {
+                    std::lock_guard<std::mutex> lock(this->m_renderMutex);
+                    this->m_renderStopping = true;
+                }
+                this->m_renderCv.notify_all();
+                this->m_renderThread.join();
+            }
+
+            /**
+             * @brief Waits until a display list is neither queued nor executing and returns it for recording
+             *
+             * @return Display list
+             */
+            inline DisplayList& acquireDisplayList() {
+                DisplayList* list = &this->m_displayLists[this->m_recordIndex];
+                std::unique_lock<std::mutex> lock(this->m_renderMutex);
+                this->m_renderCv.wait(lock, [this, list] { return list != this->m_pendingList && list != this->m_executingList; });
+                return *list;
+            }
+
+            /**
+             * @brief Redirects all drawing of the calling thread into a display list
+             *
+             * @param list Display list, gets emptied
+             */
+            inline void beginRecording(DisplayList& list) {
+                this->adoptPrewarmedGlyphs();
+                this->checkColorDamage();
+
+                list.reset();
+                Renderer::s_recording = &list;
+            }
+
+            /**
+             * @brief Stops recording on the calling thread
+             */
+            inline void endRecording() {
+                Renderer::s_recording = nullptr;
+            }
+
+            /**
+             * @brief Queues a recorded display list for the render thread
+             * @note Blocks while the previous frame still waits to be picked up
+             *
+             * @param list Display list
+             */
+            inline void submitDisplayList(DisplayList& list) {
+                {
+                    std::unique_lock<std::mutex> lock(this->m_renderMutex);
+                    this->m_renderCv.wait(lock, [this] { return this->m_pendingList == nullptr; });
+                    this->m_pendingList = &list;
+                }
+                this->m_renderCv.notify_all();
+                this->m_recordIndex ^= 1;
+            }
+
+            /**
+             * @brief Replays a display list into the current framebuffer
+             * @note Has to be called between \ref beginFramebuffer and \ref endFrame on a thread that is not recording
+             *
+             * @param list Display list
+             */
+            inline void executeDisplayList(const DisplayList& list) {
+                this->m_damageLatched = false;
+                this->updateClip();
+
+                for (const DisplayList::Command& command : list.getCommands()) {
+                    switch (command.type) {
+                        case DisplayList::CommandType::LatchDamage:
+                            this->m_damage = list.damage;
+                            this->m_damageLatched = true;
+                            this->updateClip();
+                            break;
+                        case DisplayList::CommandType::Rect:
+                            this->drawRect(command.x, command.y, command.w, command.h, command.color);
+                            break;
+                        case DisplayList::CommandType::RoundedRect:
+                            this->drawRoundedRect(command.x, command.y, command.w, command.h, command.param, command.color);
+                            break;
+                        case DisplayList::CommandType::Circle:
+                            this->drawCircle(command.x, command.y, command.param, command.flags & 1, command.color);
+                            break;
+                        case DisplayList::CommandType::QuarterCircle:
+                            this->drawQuarterCircle(command.x, command.y, command.param, command.flags & 1, command.color, command.flags >> 1);
+                            break;
+                        case DisplayList::CommandType::String: {
+                            std::lock_guard<std::recursive_mutex> lock(this->m_textMutex);
+                            this->drawTextRun(list.getString(command.index), command.flags & 1, command.x, command.y, command.param, command.color, command.w, false);
+                            break;
+                        }
+                        case DisplayList::CommandType::GlyphMask:
+                            if (command.data != nullptr)
+                                this->drawGlyph(*static_cast<const Glyph*>(command.data), command.x, command.y, command.color);
+                            break;
+                        case DisplayList::CommandType::Bitmap:
+                            if (command.data != nullptr)
+                                this->drawBitmap(command.x, command.y, command.w, command.h, static_cast<const u8*>(command.data));
+                            break;
+                        case DisplayList::CommandType::Wallpaper:
+                            this->drawWallpaper(command.color);
+                            break;
+                        case DisplayList::CommandType::FillScreen:
+                            this->fillScreen(command.color);
+                            break;
+                        case DisplayList::CommandType::ClearScreen:
+                            this->clearLayer();
+                            break;
+                        case DisplayList::CommandType::PushScissor:
+                            this->enableScissoring(command.x, command.y, command.w, command.h);
+                            break;
+                        case DisplayList::CommandType::PopScissor:
+                            this->disableScissoring();
+                            break;
+                        case DisplayList::CommandType::ReadRegion:
+                            if (command.data != nullptr)
+                                this->readRegion(static_cast<u16*>(const_cast<void*>(command.data)), command.x, command.y, command.w, command.h);
+                            break;
+                        case DisplayList::CommandType::WriteRegion:
+                            if (command.data != nullptr)
+                                this->writeRegion(static_cast<const u16*>(command.data), command.x, command.y, command.w, command.h);
+                            break;
+                    }
+                }
+            }
+        };
+        
+        /**
+         * @brief Off-screen copy of a region of the layer holding static frame decoration
+         * @note Keeps the final pixels including the background below the decoration, so the copy is dropped
+         *       whenever its key changes or the whole layer gets invalidated
+         */
+        class ChromeLayer {
+        public:
+            /**
+             * @brief Constructor for a full width band
+             *
+             * @param y Y pos of the band
+             * @param h Height of the band
+             */
+            ChromeLayer(const s32 y, const s32 h) : ChromeLayer(0, y, cfg::FramebufferWidth, h) {}
+
+            /**
+             * @brief Constructor
+             *
+             * @param x X pos of the region
+             * @param y Y pos of the region
+             * @param w Width of the region
+             * @param h Height of the region
+             */
+            ChromeLayer(const s32 x, const s32 y, const s32 w, const s32 h) : m_x(x), m_y(y), m_width(w), m_height(h) {}
+            
+            /**
+             * @brief Repaints the region from the cached pixels
+             *
+             * @param renderer Renderer
+             * @param key Everything the region's content depends on, e.g. its text
+             * @return true if the region is up to date, false if the caller has to draw it and call \ref store afterwards
+             */
+            inline bool restore(Renderer* renderer, const std::string& key) {
+                if (!this->m_valid || this->m_generation != Renderer::getLayerGeneration() || this->m_key != key) {
+                    // The region has to be drawn completely once before it can be cached
+                    if (!renderer->isRepainted(this->m_x, this->m_y, this->m_width, this->m_height))
+                        Renderer::addDamage(this->m_x, this->m_y, this->m_width, this->m_height);
+                    
+                    return false;
                 }
                 
-                // Nintendo's extended font containing a bunch of icons
-                TSL_R_TRY(plGetSharedFontByType(&extFontData, PlSharedFontType_NintendoExt));
-                
-                fontBuffer = reinterpret_cast<u8*>(extFontData.address);
-                stbtt_InitFont(&this->m_extFont, fontBuffer, stbtt_GetFontOffsetForIndex(fontBuffer, 0));
+                if (renderer->isDamaged(this->m_x, this->m_y, this->m_width, this->m_height))
+                    renderer->writeRegion(std::shared_ptr<const std::vector<u16>>(this->m_pixels), this->m_x, this->m_y, this->m_width, this->m_height);
                 
-                return 0;
-            }
-            
-            /**
-             * @brief Start a new frame
-             * @warning Don't call this more than once before calling \ref endFrame
-             */
-            inline void startFrame() {
-                this->m_currentFramebuffer = framebufferBegin(&this->m_framebuffer, nullptr);
+                return true;
             }
             
             /**
-             * @brief End the current frame
-             * @warning Don't call this before calling \ref startFrame once
+             * @brief Caches the region as it got drawn this frame
+             * @note Does nothing unless the whole region got repainted this frame
+             *
+             * @param renderer Renderer
+             * @param key Key passed to \ref restore
              */
-            inline void endFrame() {
-                this->waitForVSync();
-                framebufferEnd(&this->m_framebuffer);
+            inline void store(Renderer* renderer, const std::string& key) {
+                if (!renderer->isRepainted(this->m_x, this->m_y, this->m_width, this->m_height))
+                    return;
                 
-                this->m_currentFramebuffer = nullptr;
+                // Recorded frames still in flight keep their own reference, so the buffer outlives this layer if needed
+                if (this->m_pixels == nullptr)
+                    this->m_pixels = std::make_shared<std::vector<u16>>(this->m_width * this->m_height);
+                renderer->readRegion(this->m_pixels, this->m_x, this->m_y, this->m_width, this->m_height);
+                
+                this->m_key = key;
+                this->m_generation = Renderer::getLayerGeneration();
+                this->m_valid = true;
             }
+            
+        private:
+            s32 m_x, m_y, m_width, m_height;
+            std::shared_ptr<std::vector<u16>> m_pixels;
+            std::string m_key;
+            u32 m_generation = 0;
+            bool m_valid = false;
         };
         
     }
@@ -3756,6 +6968,15 @@ namespace tsl {
              * @param renderer Renderer
              */
             virtual void draw(gfx::Renderer *renderer) = 0;
+
+            /**
+             * @brief Gets the name the frame profiler books this element's draw time to
+             *
+             * @return Class name
+             */
+            virtual const char* getClassName() const {
+                return "Element";
+            }
             
             /**
              * @brief Called when the underlying Gui gets created and after calling \ref Gui::invalidate() to calculate positions and boundaries of the element
@@ -3775,6 +6996,7 @@ namespace tsl {
              * @param renderer
              */
             void inline frame(gfx::Renderer *renderer) {
+                const u64 profileStartNs = useFrameProfiler ? gfx::FrameProfiler::beginElement() : 0;
                 
                 if (this->m_focused) {
                     renderer->enableScissoring(0, 97, tsl::cfg::FramebufferWidth, tsl::cfg::FramebufferHeight-73-97);
@@ -3784,6 +7006,9 @@ namespace tsl {
                 }
                 
                 this->draw(renderer);
+
+                if (useFrameProfiler)
+                    gfx::FrameProfiler::endElement(this->getClassName(), profileStartNs);
             }
             
             /**
@@ -3793,10 +7018,21 @@ namespace tsl {
             void inline invalidate() {
                 const auto& parent = this->getParent();
                 
+                this->markDirty();
                 if (parent == nullptr)
                     this->layout(0, 0, cfg::FramebufferWidth, cfg::FramebufferHeight);
                 else
                     this->layout(ELEMENT_BOUNDS(parent));
+                this->markDirty();
+            }
+
+            /**
+             * @brief Flags the element for repainting
+             * @note Covers the full rows of the element plus room for the highlight border and its shake,
+             *       so separators and scrollbars reaching past the element's bounds get repainted as well
+             */
+            void inline markDirty() {
+                gfx::Renderer::addDamage(0, this->getY() - 16, cfg::FramebufferWidth, this->getHeight() + 32);
             }
             
             /**
@@ -3805,6 +7041,7 @@ namespace tsl {
              * @param direction Direction to shake highlight in
              */
             void inline shakeHighlight(FocusDirection direction) {
+                this->markDirty();
                 this->m_highlightShaking = true;
                 this->m_highlightShakingDirection = direction;
                 this->m_highlightShakingStartTime = std::chrono::steady_clock::now();
@@ -3815,6 +7052,7 @@ namespace tsl {
              *
              */
             void inline triggerClickAnimation() {
+                this->markDirty();
                 this->m_clickAnimationProgress = tsl::style::ListItemHighlightLength;
                 this->m_animationStartTime = std::chrono::steady_clock::now();
             }
@@ -3825,6 +7063,7 @@ namespace tsl {
              * @brief Resets the click animation progress, canceling the animation
              */
             void inline resetClickAnimation() {
+                this->markDirty();
                 this->m_clickAnimationProgress = 0;
             }
             
@@ -4164,9 +7403,34 @@ namespace tsl {
              * @param focused Focused
              */
             virtual inline void setFocused(bool focused) {
+                this->markDirty();
                 this->m_focused = focused;
                 this->m_clickAnimationProgress = 0;
             }
+
+            /**
+             * @brief Reports damage for animations that advance on their own
+             * @note Called once per loop iteration before drawing, also when the frame ends up being skipped
+             */
+            virtual void pollDamage() {
+                if (!this->m_focused)
+                    return;
+
+                // Repaint while anything moves and once more after it stopped
+                const bool animating = this->m_highlightShaking || this->m_clickAnimationProgress > 0 ||
+                                       runningInterpreter.load(std::memory_order_acquire) ||
+                                       downloadPercentage > 0 || unzipPercentage > 0 || copyPercentage > 0;
+                if (animating || this->m_wasAnimating)
+                    this->markDirty();
+                this->m_wasAnimating = animating;
+
+                // The pulse only needs a repaint once it actually steps to another color
+                const u32 pulseKey = Element::getHighlightPulseKey();
+                if (pulseKey != this->m_lastPulseKey) {
+                    this->m_lastPulseKey = pulseKey;
+                    this->markDirty();
+                }
+            }
             
             
             static InputMode getInputMode() { return Element::s_inputMode; }
@@ -4183,8 +7447,33 @@ namespace tsl {
             std::chrono::steady_clock::time_point m_highlightShakingStartTime;
             FocusDirection m_highlightShakingDirection;
             
+            // Last polled animation state, see pollDamage()
+            bool m_wasAnimating = false;
+            u32 m_lastPulseKey = 0;
+            
             static inline InputMode s_inputMode;
             
+            /**
+             * @brief Gets both possible highlight colors at the current pulse position
+             * @note Uses the same sine wave as drawHighlight()
+             *
+             * @return Packed colors, changes whenever the drawn highlight would
+             */
+            static inline u32 getHighlightPulseKey() {
+                const double pulse = ((std::sin(2.0 * M_PI * fmod(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(), 1.0)) + 1.0) / 2.0);
+                
+                auto mix = [pulse](const Color& from, const Color& to) -> u16 {
+                    return Color(
+                        static_cast<u8>((from.r - to.r) * pulse + to.r),
+                        static_cast<u8>((from.g - to.g) * pulse + to.g),
+                        static_cast<u8>((from.b - to.b) * pulse + to.b),
+                        0xF
+                    ).rgba;
+                };
+                
+                return (u32(mix(highlightColor1, highlightColor2)) << 16) | mix(highlightColor3, highlightColor4);
+            }
+            
             /**
              * @brief Shake animation callculation based on a damped sine wave
              *
@@ -4224,11 +7513,18 @@ namespace tsl {
              */
             CustomDrawer(std::function<void(gfx::Renderer* r, s32 x, s32 y, s32 w, s32 h)> renderFunc) : Element(), m_renderFunc(renderFunc) {}
             virtual ~CustomDrawer() {}
+
+            virtual const char* getClassName() const override {
+                return "CustomDrawer";
+            }
             
             virtual void draw(gfx::Renderer* renderer) override {
                 renderer->enableScissoring(ELEMENT_BOUNDS(this));
                 this->m_renderFunc(renderer, ELEMENT_BOUNDS(this));
                 renderer->disableScissoring();
+
+                // The render callback may draw something different every frame
+                gfx::Renderer::addDamage(ELEMENT_BOUNDS(this));
             }
             
             virtual void layout(u16 parentX, u16 parentY, u16 parentWidth, u16 parentHeight) override {
@@ -4252,6 +7548,10 @@ namespace tsl {
             
             virtual ~TableDrawer() {}
 
+            virtual const char* getClassName() const override {
+                return "TableDrawer";
+            }
+
             virtual void draw(gfx::Renderer* renderer) override {
 
                 renderer->enableScissoring(0, 97, tsl::cfg::FramebufferWidth, tsl::cfg::FramebufferHeight - 73 - 97 - 4);
@@ -4313,12 +7613,11 @@ namespace tsl {
             tsl::Color titleColor = {0xF,0xF,0xF,0xF};
             const double cycleDuration = 1.5;
             float counter = 0;
-            float countOffset;
             double timeInSeconds;
             float progress;
             float letterWidth;
             float x, y;
-            int offset, y_offset;
+            int offset;
             int fontSize;
 
             // Convert the C-style string to an std::string
@@ -4361,6 +7660,10 @@ namespace tsl {
                     delete this->m_contentElement;
             }
 
+            virtual const char* getClassName() const override {
+                return "OverlayFrame";
+            }
+
             
             // Function to calculate FPS
             //void updateFPS(double currentTimeCount) {
@@ -4380,179 +7683,416 @@ namespace tsl {
             virtual void draw(gfx::Renderer *renderer) override {
                 if (m_noClickableItems != noClickableItems)
                     noClickableItems = m_noClickableItems;
-                renderer->fillScreen(a(defaultBackgroundColor));
+
+                bool wallpaperDrawn = false;
+                if (expandedMemory && !refreshWallpaper.load(std::memory_order_acquire) && !wallpaperData.empty()) {
+                    // The pre-swizzled wallpaper covers the whole layer, including the background fill.
+                    // drawWallpaper flags inPlot on the thread that actually reads it
+                    renderer->drawWallpaper(a(defaultBackgroundColor));
+                    wallpaperDrawn = true;
+                }
+
+                if (!wallpaperDrawn)
+                    renderer->fillScreen(a(defaultBackgroundColor));
+
+
+                const bool isUltrahand = this->isUltrahandMenu();
                 
-                if (expandedMemory && !refreshWallpaper.load(std::memory_order_acquire)) {
-                    //inPlot = true;
-                    inPlot.store(true, std::memory_order_release);
-                    //std::lock_guard<std::mutex> lock(wallpaperMutex);
-                    if (!wallpaperData.empty()) {
-                        // Draw the bitmap at position (0, 0) on the screen
-                        if (!refreshWallpaper.load(std::memory_order_acquire))
-                            renderer->drawBitmap(0, 0, 448, 720, wallpaperData.data());
-                        else
-                            inPlot.store(false, std::memory_order_release);
-                    } else {
-                        inPlot.store(false, std::memory_order_release);
+                // The main menu header and the "ultra" title are animated, everything else comes from the chrome cache
+                const bool cacheHeader = !isUltrahand && this->m_colorSelection != "ultra";
+                const std::string headerKey = cacheHeader ? this->m_title + '\n' + this->m_subtitle : std::string();
+                if (!cacheHeader || !this->m_headerLayer.restore(renderer, headerKey)) {
+                    this->drawHeader(renderer, isUltrahand);
+                    if (cacheHeader)
+                        this->m_headerLayer.store(renderer, headerKey);
+                }
+                
+                if (m_noClickableItems)
+                    menuBottomLine = "\uE0E1"+GAP_2+BACK+GAP_1;
+                else
+                    menuBottomLine = "\uE0E1"+GAP_2+BACK+GAP_1+"\uE0E0"+GAP_2+OK+GAP_1;
+
+                if (this->m_menuMode == "packages") {
+                    menuBottomLine += "\uE0ED"+GAP_2+OVERLAYS;
+                } else if (this->m_menuMode == "overlays") {
+                    menuBottomLine += "\uE0EE"+GAP_2+PACKAGES;
+                }
+                
+                if (!(this->m_pageLeftName).empty()) {
+                    menuBottomLine += "\uE0ED"+GAP_2 + this->m_pageLeftName;
+                } else if (!(this->m_pageRightName).empty()) {
+                    menuBottomLine += "\uE0EE"+GAP_2 + this->m_pageRightName;
+                }
+                
+                // Touch feedback sits below the button hints, draw those directly while it's shown
+                const bool footerTouched = touchingBack || touchingSelect || touchingNextPage;
+                if (footerTouched || !this->m_footerLayer.restore(renderer, menuBottomLine)) {
+                    this->drawFooter(renderer);
+                    if (!footerTouched)
+                        this->m_footerLayer.store(renderer, menuBottomLine);
+                }
+                
+                //if (true) {
+                //    // Update FPS
+                //    updateFPS(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+                //
+                //    // Convert FPS to string
+                //    std::ostringstream fpsStream;
+                //    fpsStream << std::fixed << std::setprecision(2) << "FPS: " << fps;
+                //    std::string fpsString = fpsStream.str();
+                //    
+                //    // Draw FPS string at the bottom left corner
+                //    renderer->drawString(fpsString, false, 20, tsl::cfg::FramebufferHeight - 60, 20, a(tsl::Color(0xFF, 0xFF, 0xFF, 0xFF))); // Adjust position and color as needed
+                //    
+                //    //svcGetSystemInfo(&RAM_Used_system_u, 1, INVALID_HANDLE, 2);
+                //    //svcGetSystemInfo(&RAM_Total_system_u, 0, INVALID_HANDLE, 2);
+                //    //
+                //    //float RAM_Total_system_f = (float)RAM_Total_system_u / 1024 / 1024;
+                //    //float RAM_Used_system_f = (float)RAM_Used_system_u / 1024 / 1024;
+                //    //
+                //    //// Convert RAM usage to strings
+                //    //std::ostringstream ramStream;
+                //    //ramStream << std::fixed << std::setprecision(2)
+                //    //          << RAM_Total_system_f - RAM_Used_system_f - 8.0 << " MB free (8 MB reserved)";
+                //    //std::string ramString = ramStream.str();
+                //    //
+                //    //
+                //    //renderer->drawString(ramString.c_str(), false, 130, tsl::cfg::FramebufferHeight - 60, 20, a(tsl::Color(0xFF, 0xFF, 0xFF, 0xFF))); // Adjust position and color as needed
+                //}
+
+                
+                if (this->m_contentElement != nullptr)
+                    this->m_contentElement->frame(renderer);
+
+            }
+            // CUSTOM SECTION END
+            
+            virtual inline void layout(u16 parentX, u16 parentY, u16 parentWidth, u16 parentHeight) override {
+                this->setBoundaries(parentX, parentY, parentWidth, parentHeight);
+                
+                if (this->m_contentElement != nullptr) {
+                    this->m_contentElement->setBoundaries(parentX + 35, parentY + 97, parentWidth - 85, parentHeight - 73 - 105); // CUSTOM MODIFICATION (125->105->102)
+                    this->m_contentElement->invalidate();
+                }
+            }
+            
+            virtual inline Element* requestFocus(Element *oldFocus, FocusDirection direction) override {
+                if (this->m_contentElement != nullptr)
+                    return this->m_contentElement->requestFocus(oldFocus, direction);
+                else
+                    return nullptr;
+            }
+            
+            virtual inline bool onTouch(TouchEvent event, s32 currX, s32 currY, s32 prevX, s32 prevY, s32 initialX, s32 initialY) {
+                // Discard touches outside bounds
+                if (!this->m_contentElement->inBounds(currX, currY) || !internalTouchReleased)
+                    return false;
+                
+                if (this->m_contentElement != nullptr)
+                    return this->m_contentElement->onTouch(event, currX, currY, prevX, prevY, initialX, initialY);
+                else return false;
+            }
+            
+            /**
+             * @brief Sets the content of the frame
+             *
+             * @param content Element
+             */
+            inline void setContent(Element *content) {
+                if (this->m_contentElement != nullptr)
+                    delete this->m_contentElement;
+                
+                this->m_contentElement = content;
+                
+                if (content != nullptr) {
+                    this->m_contentElement->setParent(this);
+                    this->invalidate();
+                }
+            }
+            
+            /**
+             * @brief Changes the title of the menu
+             *
+             * @param title Title to change to
+             */
+            inline void setTitle(const std::string &title) {
+                this->m_title = title;
+                gfx::Renderer::addDamage(0, 0, cfg::FramebufferWidth, 97);
+            }
+            
+            /**
+             * @brief Changes the subtitle of the menu
+             *
+             * @param title Subtitle to change to
+             */
+            inline void setSubtitle(const std::string &subtitle) {
+                this->m_subtitle = subtitle;
+                gfx::Renderer::addDamage(0, 0, cfg::FramebufferWidth, 97);
+            }
+            
+            /**
+             * @brief Adds damage for the parts of the frame that change on their own (animated logo, status bar, touch feedback)
+             * @note Runs before the background gets cleared, so everything reported here is part of the upcoming frame
+             */
+            virtual void pollDamage() override {
+                static bool lastWallpaperReady = false;
+                const bool wallpaperReady = expandedMemory && !refreshWallpaper.load(std::memory_order_acquire) && !wallpaperData.empty();
+                if (wallpaperReady != lastWallpaperReady) {
+                    gfx::Renderer::invalidateAll();
+                    lastWallpaperReady = wallpaperReady;
+                }
+
+                if (this->isUltrahandMenu()) {
+                    if (!disableColorfulLogo) {
+                        // Only repaint the logo once one of its letters steps to another color
+                        this->m_logoTime = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                        
+                        // The letter colors are computed here once per frame and reused by drawLogo()
+                        u64 logoKey = 0;
+                        float letterOffset = 0;
+                        this->m_logoColors.resize(SPLIT_PROJECT_NAME_1.size(), Color(0));
+                        for (Color& letterColor : this->m_logoColors) {
+                            letterColor = this->getLogoLetterColor(this->m_logoTime, letterOffset);
+                            logoKey = logoKey * 0x10001 + letterColor.rgba;
+                            letterOffset -= 0.2F;
+                        }
+                        
+                        if (logoKey != this->m_lastLogoKey) {
+                            gfx::Renderer::addDamage(0, 0, 245, 97);
+                            this->m_lastLogoKey = logoKey;
+                        }
+                    }
+
+                    clock_gettime(CLOCK_REALTIME, &currentTime);
+                    if (currentTime.tv_sec != this->m_lastStatusSecond) {
+                        gfx::Renderer::addDamage(245, 0, cfg::FramebufferWidth - 245, 97);
+                        this->m_lastStatusSecond = currentTime.tv_sec;
+                    }
+
+                    const u8 hideFlags = u8(hideClock) | (u8(hideBattery) << 1) | (u8(hidePCBTemp) << 2) | (u8(hideSOCTemp) << 3);
+                    if (hideFlags != this->m_lastHideFlags) {
+                        gfx::Renderer::addDamage(0, 0, cfg::FramebufferWidth, 97);
+                        this->m_lastHideFlags = hideFlags;
                     }
-                    //inPlot = false;
+                } else if (this->m_colorSelection == "ultra") {
+                    gfx::Renderer::addDamage(0, 0, cfg::FramebufferWidth, 97);
+                }
+
+                const u8 touchFlags = u8(touchingBack) | (u8(touchingSelect) << 1) | (u8(touchingNextPage) << 2) | (u8(touchingMenu && inMainMenu) << 3);
+                if ((touchFlags ^ this->m_lastTouchFlags) & 0x7)
+                    gfx::Renderer::addDamage(0, cfg::FramebufferHeight - 73, cfg::FramebufferWidth, 73);
+                if ((touchFlags ^ this->m_lastTouchFlags) & 0x8)
+                    gfx::Renderer::addDamage(0, 0, 245, 97);
+                this->m_lastTouchFlags = touchFlags;
+            }
+            
+        protected:
+            Element *m_contentElement = nullptr;
+
+            time_t m_lastStatusSecond = 0;
+            u8 m_lastHideFlags = 0;
+            u8 m_lastTouchFlags = 0;
+            double m_logoTime = 0;
+            u64 m_lastLogoKey = 0;
+            std::vector<Color> m_logoColors;
+            gfx::GlyphRun m_logoRun;
+            std::shared_ptr<const gfx::Glyph> m_logoStrip;
+            s32 m_logoStripFontSize = 0;
+            gfx::ChromeLayer m_logoLayer{ 0, 0, 245, 97 };
+
+            // Static title and footer pixels, see ChromeLayer
+            gfx::ChromeLayer m_headerLayer{ 0, 97 };
+            gfx::ChromeLayer m_footerLayer{ tsl::cfg::FramebufferHeight - 73, 73 };
+
+            // Clock, temperature and battery widget right of the logo separator, see updateStatusWidget()
+            gfx::ChromeLayer m_statusLayer{ 246, 0, tsl::cfg::FramebufferWidth - 246, 97 };
+            time_t m_statusSecond = 0;
+            u8 m_statusHideFlags = 0xFF;
+            std::string m_clockText, m_statusKey;
+            char m_pcbTemperatureStr[10] = "", m_socTemperatureStr[10] = "";
+            float m_clockWidth = 0, m_chargeWidth = 0, m_pcbTemperatureWidth = 0, m_socTemperatureWidth = 0;
+
+            /**
+             * @brief Refreshes the texts and layout of the clock, temperature and battery widget
+             * @note Does nothing until the second ticks or a part of the widget gets shown or hidden
+             *
+             * @param renderer Renderer
+             */
+            inline void updateStatusWidget(gfx::Renderer *renderer) {
+                const u8 hideFlags = u8(hideClock) | (u8(hideBattery) << 1) | (u8(hidePCBTemp) << 2) | (u8(hideSOCTemp) << 3);
+                if (currentTime.tv_sec == this->m_statusSecond && hideFlags == this->m_statusHideFlags)
+                    return;
+                this->m_statusSecond = currentTime.tv_sec;
+                this->m_statusHideFlags = hideFlags;
+
+                this->m_clockText.clear();
+                if (!hideClock) {
+                    char timeStr[20];
+                    strftime(timeStr, sizeof(timeStr), datetimeFormat.c_str(), localtime(&currentTime.tv_sec));
+                    this->m_clockText = localizeTimeStr(timeStr);
+                }
+
+                if (!hideSOCTemp) {
+                    ReadSocTemperature(&SOC_temperature);
+                    snprintf(this->m_socTemperatureStr, sizeof(this->m_socTemperatureStr) - 1, "%d°C", SOC_temperature);
+                } else {
+                    strcpy(this->m_socTemperatureStr, "");
+                    SOC_temperature = 0;
+                }
+                if (!hidePCBTemp) {
+                    ReadPcbTemperature(&PCB_temperature);
+                    snprintf(this->m_pcbTemperatureStr, sizeof(this->m_pcbTemperatureStr) - 1, "%d°C", PCB_temperature);
+                } else {
+                    strcpy(this->m_pcbTemperatureStr, "");
+                    PCB_temperature = 0;
+                }
+                if (!hideBattery) {
+                    powerGetDetails(&batteryCharge, &isCharging);
+                    batteryCharge = std::min(batteryCharge, 100U);
+                    sprintf(chargeString, "%d%%", batteryCharge);
+                } else {
+                    strcpy(chargeString, "");
+                    batteryCharge = 0;
+                }
+                timeOut = int(currentTime.tv_sec);
+
+                this->m_clockWidth = renderer->calculateStringWidth(this->m_clockText, 20, true);
+                this->m_chargeWidth = renderer->calculateStringWidth(chargeString, 20, true);
+                this->m_pcbTemperatureWidth = renderer->calculateStringWidth(this->m_pcbTemperatureStr, 20, true);
+                this->m_socTemperatureWidth = renderer->calculateStringWidth(this->m_socTemperatureStr, 20, true);
+
+                // Everything the widget's pixels depend on besides theme and opacity, those invalidate the whole layer
+                this->m_statusKey = this->m_clockText + '\n' + chargeString + '\n' + this->m_pcbTemperatureStr + '\n' +
+                                    this->m_socTemperatureStr + '\n' + char('0' + isCharging) + char('0' + hideFlags);
+            }
+
+            /**
+             * @brief Draws the clock, temperature and battery widget laid out by updateStatusWidget()
+             *
+             * @param renderer Renderer
+             */
+            inline void drawStatusWidget(gfx::Renderer *renderer) {
+                s32 statusY = 45;
+                if ((hideBattery && hidePCBTemp && hideSOCTemp) || hideClock)
+                    statusY += 10;
+
+                if (!hideClock) {
+                    renderer->drawString(this->m_clockText, false, tsl::cfg::FramebufferWidth - this->m_clockWidth - 20, statusY, 20, a(clockColor));
+                    statusY += 22;
+                }
+
+                if (!hideBattery && batteryCharge > 0) {
+                    Color batteryColorToUse = isCharging ? tsl::Color(0x0, 0xF, 0x0, 0xF) : 
+                                            (batteryCharge < 20 ? tsl::Color(0xF, 0x0, 0x0, 0xF) : batteryColor);
+                    renderer->drawString(chargeString, false, tsl::cfg::FramebufferWidth - this->m_chargeWidth - 22, statusY, 20, a(batteryColorToUse));
+                }
+
+                s32 statusOffset = 0;
+                if (!hidePCBTemp && PCB_temperature > 0) {
+                    if (!hideBattery)
+                        statusOffset -= 5;
+                    renderer->drawString(this->m_pcbTemperatureStr, false, tsl::cfg::FramebufferWidth + statusOffset - this->m_pcbTemperatureWidth - this->m_chargeWidth - 22, statusY, 20, a(tsl::GradientColor(PCB_temperature)));
+                }
+
+                if (!hideSOCTemp && SOC_temperature > 0) {
+                    if (!hidePCBTemp || !hideBattery)
+                        statusOffset -= 5;
+                    renderer->drawString(this->m_socTemperatureStr, false, tsl::cfg::FramebufferWidth + statusOffset - this->m_socTemperatureWidth - this->m_pcbTemperatureWidth - this->m_chargeWidth - 22, statusY, 20, a(tsl::GradientColor(SOC_temperature)));
+                }
+            }
+
+            /**
+             * @brief Checks if this frame shows the main menu header with logo and status bar
+             *
+             * @return true for the Ultrahand main menu
+             */
+            inline bool isUltrahandMenu() const {
+                return (this->m_title == CAPITAL_ULTRAHAND_PROJECT_NAME && 
+                        this->m_subtitle.find("Ultrahand Package") == std::string::npos && 
+                        this->m_subtitle.find("Ultrahand Script") == std::string::npos);
+            }
+
+            /**
+             * @brief Computes the color of a letter of the animated logo
+             *
+             * @param timeCount Time in seconds
+             * @param letterOffset Phase offset of the letter
+             * @return Letter color
+             */
+            inline Color getLogoLetterColor(double timeCount, float letterOffset) {
+                counter = (2 * M_PI * (fmod(timeCount, cycleDuration) + letterOffset) / 1.5);
+                const float progress = std::sin(counter); // -1 to 1
+                
+                return {
+                    static_cast<u8>((std::get<0>(dynamicLogoRGB2) - std::get<0>(dynamicLogoRGB1)) * (progress + 1.0) / 2.0 + std::get<0>(dynamicLogoRGB1)),
+                    static_cast<u8>((std::get<1>(dynamicLogoRGB2) - std::get<1>(dynamicLogoRGB1)) * (progress + 1.0) / 2.0 + std::get<1>(dynamicLogoRGB1)),
+                    static_cast<u8>((std::get<2>(dynamicLogoRGB2) - std::get<2>(dynamicLogoRGB1)) * (progress + 1.0) / 2.0 + std::get<2>(dynamicLogoRGB1)),
+                    15
+                };
+            }
+
+            /**
+             * @brief Draws the Ultrahand logo
+             * @note The letters of the first part are laid out once into \ref m_logoRun and only get tinted per frame,
+             *       the second part is a single color and drawn from a pre-rendered strip
+             *
+             * @param renderer Renderer
+             * @param logoTouched Draw the touch highlight behind the logo
+             */
+            inline void drawLogo(gfx::Renderer *renderer, bool logoTouched) {
+                if (logoTouched) {
+                    renderer->drawRoundedRect(0.0f, 12.0f, 245.0f, 73.0f, 6.0f, a(clickColor));
                 }
-                
 
+                renderer->layoutGlyphRun(this->m_logoRun, SPLIT_PROJECT_NAME_1, x, fontSize);
+                const bool colorful = !disableColorfulLogo && this->m_logoColors.size() == this->m_logoRun.penX.size();
+                // Use the colors computed by pollDamage() so the drawn colors match the ones that got checked
+                renderer->drawGlyphRun(this->m_logoRun, y + offset, [&](const size_t i) {
+                    return a(colorful ? this->m_logoColors[i] : logoColor1);
+                });
+                x = this->m_logoRun.endX;
+
+                if (this->m_logoStrip == nullptr || this->m_logoStripFontSize != fontSize) {
+                    this->m_logoStrip = renderer->renderTextStrip(SPLIT_PROJECT_NAME_2, fontSize);
+                    this->m_logoStripFontSize = fontSize;
+                }
+                renderer->drawTextStrip(this->m_logoStrip, static_cast<s32>(x), y + offset, a(logoColor2));
+            }
+
+            /**
+             * @brief Draws the title area: logo and status bar in the main menu, title and subtitle everywhere else
+             *
+             * @param renderer Renderer
+             * @param isUltrahand Whether the main menu header is shown
+             */
+            inline void drawHeader(gfx::Renderer *renderer, bool isUltrahand) {
                 y = 50;
                 offset = 0;
-                
-                bool isUltrahand = (this->m_title == CAPITAL_ULTRAHAND_PROJECT_NAME && 
-                                    this->m_subtitle.find("Ultrahand Package") == std::string::npos && 
-                                    this->m_subtitle.find("Ultrahand Script") == std::string::npos);
 
                 if (isUltrahand) {
-
-                    if (touchingMenu && inMainMenu) {
-                        renderer->drawRoundedRect(0.0f, 12.0f, 245.0f, 73.0f, 6.0f, a(clickColor));
-                    }
-                    
-                    
                     x = 20;
                     fontSize = 42;
                     offset = 6;
-                    
-                    countOffset = 0;
-                    
 
-                    if (!disableColorfulLogo) {
-                        //auto currentTime = std::chrono::steady_clock::now();
-                        auto currentTimeCount = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
-                        float progress;
-                        for (char letter : SPLIT_PROJECT_NAME_1) {
-                            counter = (2 * M_PI * (fmod(currentTimeCount, cycleDuration) + countOffset) / 1.5);
-                            progress = std::sin(counter); // -1 to 1
-                            
-                            highlightColor = {
-                                static_cast<u8>((std::get<0>(dynamicLogoRGB2) - std::get<0>(dynamicLogoRGB1)) * (progress + 1.0) / 2.0 + std::get<0>(dynamicLogoRGB1)),
-                                static_cast<u8>((std::get<1>(dynamicLogoRGB2) - std::get<1>(dynamicLogoRGB1)) * (progress + 1.0) / 2.0 + std::get<1>(dynamicLogoRGB1)),
-                                static_cast<u8>((std::get<2>(dynamicLogoRGB2) - std::get<2>(dynamicLogoRGB1)) * (progress + 1.0) / 2.0 + std::get<2>(dynamicLogoRGB1)),
-                                15
-                            };
-                            
-                            renderer->drawString(std::string(1, letter), false, x, y + offset, fontSize, a(highlightColor));
-                            x += renderer->calculateStringWidth(std::string(1, letter), fontSize);
-                            countOffset -= 0.2F;
-                        }
-                    } else {
-                        for (char letter : SPLIT_PROJECT_NAME_1) {
-                            renderer->drawString(std::string(1, letter), false, x, y + offset, fontSize, a(logoColor1));
-                            x += renderer->calculateStringWidth(std::string(1, letter), fontSize);
-                            countOffset -= 0.2F;
-                        }
+                    // A static logo only changes while it's touched, draw it directly then like the footer
+                    const bool logoTouched = touchingMenu && inMainMenu;
+                    const bool cacheLogo = disableColorfulLogo && !logoTouched;
+                    if (!cacheLogo || !this->m_logoLayer.restore(renderer, SPLIT_PROJECT_NAME_1)) {
+                        this->drawLogo(renderer, logoTouched);
+                        if (cacheLogo)
+                            this->m_logoLayer.store(renderer, SPLIT_PROJECT_NAME_1);
                     }
                     
-                    renderer->drawString(SPLIT_PROJECT_NAME_2, false, x, y + offset, fontSize, a(logoColor2));
-                    
                     if (!(hideBattery && hidePCBTemp && hideSOCTemp && hideClock)) {
                         renderer->drawRect(245, 23, 1, 49, a(separatorColor));
                     }
                     
                     
-                    y_offset = 45;
-                    if ((hideBattery && hidePCBTemp && hideSOCTemp) || hideClock) {
-                        y_offset += 10;
-                    }
-                    
-                    clock_gettime(CLOCK_REALTIME, &currentTime);
-                    if (!hideClock) {
-                        static char timeStr[20]; // Allocate a buffer to store the time string
-                        strftime(timeStr, sizeof(timeStr), datetimeFormat.c_str(), localtime(&currentTime.tv_sec));
-                        localizeTimeStr(timeStr);
-                        renderer->drawString(timeStr, false, tsl::cfg::FramebufferWidth - renderer->calculateStringWidth(timeStr, 20, true) - 20, y_offset, 20, a(clockColor));
-                        y_offset += 22;
-                    }
-                    
-                    //if ((currentTimeSpec.tv_sec - timeOut) >= 1) {
-                    //    if (!isHidden.load()) {
-                    //        if (!hidePCBTemp) thermalstatusGetDetailsPCB(&PCB_temperature);
-                    //        if (!hideSOCTemp) thermalstatusGetDetailsSOC(&SOC_temperature);
-                    //        if (!hideBattery) powerGetDetails(&batteryCharge, &isCharging);
-                    //    }
-                    //    timeOut = int(currentTimeSpec.tv_sec);
-                    //}
-                    //if (!isHidden.load()) {
-
-                    static char PCB_temperatureStr[10];
-                    static char SOC_temperatureStr[10];
-
-
-                    size_t statusChange = size_t(hideSOCTemp) + size_t(hidePCBTemp) + size_t(hideBattery);
-                    static size_t lastStatusChange = 0;
-
-                    if ((currentTime.tv_sec - timeOut) >= 1 || statusChange != lastStatusChange) {
-                        //if (!hidePCBTemp || !hideSOCTemp) {
-                        //    //thermalstatusInit();
-                        //    //if (!hidePCBTemp)
-                        //    //    thermalstatusGetDetailsPCB(&PCB_temperature);
-                        //    //if (!hideSOCTemp)
-                        //    //    thermalstatusGetDetailsSOC(&SOC_temperature);
-                        //    //thermalstatusExit();
-                        //}
-                        if (!hideSOCTemp) {
-                            ReadSocTemperature(&SOC_temperature);
-                            snprintf(SOC_temperatureStr, sizeof(SOC_temperatureStr) - 1, "%d°C", SOC_temperature);
-                        } else {
-                            strcpy(SOC_temperatureStr, "");
-                            SOC_temperature=0;
-                        }
-                        if (!hidePCBTemp) {
-                            ReadPcbTemperature(&PCB_temperature);
-                            snprintf(PCB_temperatureStr, sizeof(PCB_temperatureStr) - 1, "%d°C", PCB_temperature);
-                        } else {
-                            strcpy(PCB_temperatureStr, "");
-                            PCB_temperature=0;
-                        }
-                        if (!hideBattery) {
-                            powerGetDetails(&batteryCharge, &isCharging);
-                            batteryCharge = std::min(batteryCharge, 100U);
-                            sprintf(chargeString, "%d%%", batteryCharge);
-                        } else {
-                            strcpy(chargeString, "");
-                            batteryCharge=0;
-                        }
-                        timeOut = int(currentTime.tv_sec);
-                    }
-
-                    lastStatusChange = statusChange;
-
-                    
-                    //if (hideSOCTemp && (SOC_temperature > 0 || strlen(SOC_temperatureStr) > 0)) {
-                    //    strcpy(SOC_temperatureStr, "");
-                    //    SOC_temperature=0;
-                    //}
-                    //if (hidePCBTemp && (PCB_temperature > 0 || strlen(PCB_temperatureStr) > 0)) {
-                    //    strcpy(PCB_temperatureStr, "");
-                    //    PCB_temperature=0;
-                    //}
-                    //if (hideBattery && (batteryCharge > 0 || strlen(chargeString) > 0)) {
-                    //    strcpy(chargeString, "");
-                    //    batteryCharge=0;
-                    //}
-                    
-                    
-                    if (!hideBattery && batteryCharge > 0) {
-                        Color batteryColorToUse = isCharging ? tsl::Color(0x0, 0xF, 0x0, 0xF) : 
-                                                (batteryCharge < 20 ? tsl::Color(0xF, 0x0, 0x0, 0xF) : batteryColor);
-                        renderer->drawString(chargeString, false, tsl::cfg::FramebufferWidth - renderer->calculateStringWidth(chargeString, 20, true) - 22, y_offset, 20, a(batteryColorToUse));
-                    }
-                    
-                    offset = 0;
-                    if (!hidePCBTemp && PCB_temperature > 0) {
-                        if (!hideBattery)
-                            offset -= 5;
-                        renderer->drawString(PCB_temperatureStr, false, tsl::cfg::FramebufferWidth + offset - renderer->calculateStringWidth(PCB_temperatureStr, 20, true) - renderer->calculateStringWidth(chargeString, 20, true) - 22, y_offset, 20, a(tsl::GradientColor(PCB_temperature)));
-                    }
-                    
-                    if (!hideSOCTemp && SOC_temperature > 0) {
-                        if (!hidePCBTemp || !hideBattery)
-                            offset -= 5;
-                        renderer->drawString(SOC_temperatureStr, false, tsl::cfg::FramebufferWidth + offset - renderer->calculateStringWidth(SOC_temperatureStr, 20, true) - renderer->calculateStringWidth(PCB_temperatureStr, 20, true) - renderer->calculateStringWidth(chargeString, 20, true) - 22, y_offset, 20, a(tsl::GradientColor(SOC_temperature)));
+                    // The texts change once per second at most, in between the widget is repainted from its cached pixels
+                    this->updateStatusWidget(renderer);
+                    if (!this->m_statusLayer.restore(renderer, this->m_statusKey)) {
+                        this->drawStatusWidget(renderer);
+                        this->m_statusLayer.store(renderer, this->m_statusKey);
                     }
                 } else {
                     x = 20;
@@ -4640,7 +8180,14 @@ namespace tsl {
                     renderer->drawString(versionLabel, false, 20, y+25, 15, a(versionTextColor));
                 } else
                     renderer->drawString(this->m_subtitle, false, 20, y+20, 15, a(versionTextColor));
-                
+            }
+
+            /**
+             * @brief Draws the footer: separator, touch feedback and button hints
+             *
+             * @param renderer Renderer
+             */
+            inline void drawFooter(gfx::Renderer *renderer) {
                 renderer->drawRect(15, tsl::cfg::FramebufferHeight - 73, tsl::cfg::FramebufferWidth - 30, 1, a(botttomSeparatorColor));
                 
                 backWidth = renderer->calculateStringWidth(BACK, 23);
@@ -4673,126 +8220,11 @@ namespace tsl {
                 }
 
 
-                if (m_noClickableItems)
-                    menuBottomLine = "\uE0E1"+GAP_2+BACK+GAP_1;
-                else
-                    menuBottomLine = "\uE0E1"+GAP_2+BACK+GAP_1+"\uE0E0"+GAP_2+OK+GAP_1;
-
-                if (this->m_menuMode == "packages") {
-                    menuBottomLine += "\uE0ED"+GAP_2+OVERLAYS;
-                } else if (this->m_menuMode == "overlays") {
-                    menuBottomLine += "\uE0EE"+GAP_2+PACKAGES;
-                }
-                
-                if (!(this->m_pageLeftName).empty()) {
-                    menuBottomLine += "\uE0ED"+GAP_2 + this->m_pageLeftName;
-                } else if (!(this->m_pageRightName).empty()) {
-                    menuBottomLine += "\uE0EE"+GAP_2 + this->m_pageRightName;
-                }
-                
                 //renderer->drawString(menuBottomLine.c_str(), false, 30, 693, 23, a(defaultTextColor));
                 // Render the text with special character handling
                 renderer->drawStringWithColoredSections(menuBottomLine, {"\uE0E1","\uE0E0","\uE0ED","\uE0EE"}, 30, 693, 23, a(bottomTextColor), a(buttonColor));
-                
-                //if (true) {
-                //    // Update FPS
-                //    updateFPS(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
-                //
-                //    // Convert FPS to string
-                //    std::ostringstream fpsStream;
-                //    fpsStream << std::fixed << std::setprecision(2) << "FPS: " << fps;
-                //    std::string fpsString = fpsStream.str();
-                //    
-                //    // Draw FPS string at the bottom left corner
-                //    renderer->drawString(fpsString, false, 20, tsl::cfg::FramebufferHeight - 60, 20, a(tsl::Color(0xFF, 0xFF, 0xFF, 0xFF))); // Adjust position and color as needed
-                //    
-                //    //svcGetSystemInfo(&RAM_Used_system_u, 1, INVALID_HANDLE, 2);
-                //    //svcGetSystemInfo(&RAM_Total_system_u, 0, INVALID_HANDLE, 2);
-                //    //
-                //    //float RAM_Total_system_f = (float)RAM_Total_system_u / 1024 / 1024;
-                //    //float RAM_Used_system_f = (float)RAM_Used_system_u / 1024 / 1024;
-                //    //
-                //    //// Convert RAM usage to strings
-                //    //std::ostringstream ramStream;
-                //    //ramStream << std::fixed << std::setprecision(2)
-                //    //          << RAM_Total_system_f - RAM_Used_system_f - 8.0 << " MB free (8 MB reserved)";
-                //    //std::string ramString = ramStream.str();
-                //    //
-                //    //
-                //    //renderer->drawString(ramString.c_str(), false, 130, tsl::cfg::FramebufferHeight - 60, 20, a(tsl::Color(0xFF, 0xFF, 0xFF, 0xFF))); // Adjust position and color as needed
-                //}
-
-                
-                if (this->m_contentElement != nullptr)
-                    this->m_contentElement->frame(renderer);
-
-            }
-            // CUSTOM SECTION END
-            
-            virtual inline void layout(u16 parentX, u16 parentY, u16 parentWidth, u16 parentHeight) override {
-                this->setBoundaries(parentX, parentY, parentWidth, parentHeight);
-                
-                if (this->m_contentElement != nullptr) {
-                    this->m_contentElement->setBoundaries(parentX + 35, parentY + 97, parentWidth - 85, parentHeight - 73 - 105); // CUSTOM MODIFICATION (125->105->102)
-                    this->m_contentElement->invalidate();
-                }
-            }
-            
-            virtual inline Element* requestFocus(Element *oldFocus, FocusDirection direction) override {
-                if (this->m_contentElement != nullptr)
-                    return this->m_contentElement->requestFocus(oldFocus, direction);
-                else
-                    return nullptr;
-            }
-            
-            virtual inline bool onTouch(TouchEvent event, s32 currX, s32 currY, s32 prevX, s32 prevY, s32 initialX, s32 initialY) {
-                // Discard touches outside bounds
-                if (!this->m_contentElement->inBounds(currX, currY) || !internalTouchReleased)
-                    return false;
-                
-                if (this->m_contentElement != nullptr)
-                    return this->m_contentElement->onTouch(event, currX, currY, prevX, prevY, initialX, initialY);
-                else return false;
-            }
-            
-            /**
-             * @brief Sets the content of the frame
-             *
-             * @param content Element
-             */
-            inline void setContent(Element *content) {
-                if (this->m_contentElement != nullptr)
-                    delete this->m_contentElement;
-                
-                this->m_contentElement = content;
-                
-                if (content != nullptr) {
-                    this->m_contentElement->setParent(this);
-                    this->invalidate();
-                }
-            }
-            
-            /**
-             * @brief Changes the title of the menu
-             *
-             * @param title Title to change to
-             */
-            inline void setTitle(const std::string &title) {
-                this->m_title = title;
-            }
-            
-            /**
-             * @brief Changes the subtitle of the menu
-             *
-             * @param title Subtitle to change to
-             */
-            inline void setSubtitle(const std::string &subtitle) {
-                this->m_subtitle = subtitle;
             }
             
-        protected:
-            Element *m_contentElement = nullptr;
-            
             //std::string m_title, m_subtitle;
         };
         
@@ -4811,15 +8243,24 @@ namespace tsl {
                 if (this->m_header != nullptr)
                     delete this->m_header;
             }
+
+            virtual const char* getClassName() const override {
+                return "HeaderOverlayFrame";
+            }
             
             virtual void draw(gfx::Renderer *renderer) override {
                 renderer->fillScreen(a(defaultBackgroundColor));
                 //renderer->fillScreen(tsl::style::color::ColorFrameBackground);
-                renderer->drawRect(tsl::cfg::FramebufferWidth - 1, 0, 1, tsl::cfg::FramebufferHeight, a(0xF222));
-                
-                renderer->drawRect(15, tsl::cfg::FramebufferHeight - 73, tsl::cfg::FramebufferWidth - 30, 1, a(defaultTextColor));
-                
-                renderer->drawString(("\uE0E1  "+BACK+"     \uE0E0  "+OK), false, 30, 693, 23, a(defaultTextColor)); // CUSTOM MODIFICATION
+                renderer->drawRect(tsl::cfg::FramebufferWidth - 1, 0, 1, tsl::cfg::FramebufferHeight - 73, a(0xF222));
+                
+                // The footer only changes with the language, so it comes from the chrome cache
+                const std::string footerText = "\uE0E1  "+BACK+"     \uE0E0  "+OK; // CUSTOM MODIFICATION
+                if (!this->m_footerLayer.restore(renderer, footerText)) {
+                    renderer->drawRect(tsl::cfg::FramebufferWidth - 1, tsl::cfg::FramebufferHeight - 73, 1, 73, a(0xF222));
+                    renderer->drawRect(15, tsl::cfg::FramebufferHeight - 73, tsl::cfg::FramebufferWidth - 30, 1, a(defaultTextColor));
+                    renderer->drawString(footerText, false, 30, 693, 23, a(defaultTextColor));
+                    this->m_footerLayer.store(renderer, footerText);
+                }
                 
                 if (this->m_header != nullptr)
                     this->m_header->frame(renderer);
@@ -4898,6 +8339,8 @@ namespace tsl {
             CustomDrawer *m_header = nullptr;
             
             u16 m_headerHeight;
+            
+            gfx::ChromeLayer m_footerLayer{ tsl::cfg::FramebufferHeight - 73, 73 };
         };
         
         /**
@@ -4913,6 +8356,10 @@ namespace tsl {
              */
             DebugRectangle(Color color) : Element(), m_color(color) {}
             virtual ~DebugRectangle() {}
+
+            virtual const char* getClassName() const override {
+                return "DebugRectangle";
+            }
             
             virtual void draw(gfx::Renderer *renderer) override {
                 renderer->drawRect(ELEMENT_BOUNDS(this), a(this->m_color));
@@ -4946,6 +8393,10 @@ namespace tsl {
                 this->invalidate();
                 this->m_clearList = false;
             }
+
+            virtual const char* getClassName() const override {
+                return "List";
+            }
             
             u32 scrollbarHeight;
             u32 scrollbarOffset;
@@ -5039,7 +8490,9 @@ namespace tsl {
                 renderer->enableScissoring(this->getLeftBound(), topBound, width + 4, height + 4);
             
                 for (auto& entry : this->m_items) {
-                    if (entry->getBottomBound() > topBound && entry->getTopBound() < bottomBound) {
+                    // Skip entries whose rows (including highlight and separators) weren't damaged this frame
+                    if (entry->getBottomBound() > topBound && entry->getTopBound() < bottomBound &&
+                        renderer->isDamaged(0, entry->getY() - 16, tsl::cfg::FramebufferWidth, entry->getHeight() + 32)) {
                         entry->frame(renderer);
                     }
                 }
@@ -5748,6 +9201,10 @@ namespace tsl {
                 applyLangReplacements(this->m_value, true);
             }
             virtual ~ListItem() {}
+
+            virtual const char* getClassName() const override {
+                return "ListItem";
+            }
             
             virtual void draw(gfx::Renderer *renderer) override {
                 static float lastBottomBound;
@@ -5775,6 +9232,7 @@ namespace tsl {
                     std::tie(width, height) = renderer->drawString(this->m_text, false, 0, 0, 23, a(tsl::style::color::ColorTransparent));
                     this->m_trunctuated = width > this->m_maxWidth+20;
                     
+                    this->m_scrollStrip.reset();
                     if (this->m_trunctuated) {
                         this->m_scrollText = this->m_text + "        ";
                         std::tie(width, height) = renderer->drawString(this->m_scrollText, false, 0, 0, 23, a(tsl::style::color::ColorTransparent));
@@ -5799,7 +9257,10 @@ namespace tsl {
                             renderer->enableScissoring(this->getX()+6, 97, this->m_maxWidth + 40 - 6-4, tsl::cfg::FramebufferHeight-73-97);
                         else
                             renderer->enableScissoring(this->getX()+6, 97, this->m_maxWidth + 40 - 6, tsl::cfg::FramebufferHeight-73-97);
-                        renderer->drawString(this->m_scrollText, false, this->getX() + 20-1 - this->m_scrollOffset, this->getY() + 45, 23, a(selectedTextColor));
+                        // The marquee is rasterized once per focus, every frame only blends the part inside the scissor rect
+                        if (this->m_scrollStrip == nullptr)
+                            this->m_scrollStrip = renderer->renderTextStrip(this->m_scrollText, 23);
+                        renderer->drawTextStrip(this->m_scrollStrip, this->getX() + 20-1 - this->m_scrollOffset, this->getY() + 45, a(selectedTextColor));
                         renderer->disableScissoring();
                         //t = std::chrono::steady_clock::now() - this->timeIn;
                         if (std::chrono::steady_clock::now() - this->timeIn >= 2000ms) {
@@ -5876,11 +9337,13 @@ namespace tsl {
                     if (this->m_touched) {
                         // Start the timer when touch begins
                         m_touchStartTime = std::chrono::steady_clock::now();
+                        this->markDirty();
                     }
                 }
         
                 if (event == TouchEvent::Release && this->m_touched) {
                     this->m_touched = false;
+                    this->markDirty();
                     
                     if (Element::getInputMode() == InputMode::Touch) {
                         // Calculate the touch duration
@@ -5903,10 +9366,19 @@ namespace tsl {
             virtual void setFocused(bool state) override {
                 this->m_scroll = false;
                 this->m_scrollOffset = 0;
+                this->m_scrollStrip.reset();
                 this->timeIn = std::chrono::steady_clock::now(); // CUSTOM MODIFICATION
                 Element::setFocused(state);
             }
             
+            virtual void pollDamage() override {
+                // Truncated text keeps scrolling while focused
+                if (this->m_focused && this->m_trunctuated)
+                    this->markDirty();
+                
+                Element::pollDamage();
+            }
+            
             virtual inline Element* requestFocus(Element *oldFocus, FocusDirection direction) override {
                 return this;
             }
@@ -5919,8 +9391,10 @@ namespace tsl {
             inline void setText(const std::string& text) {
                 this->m_text = text;
                 this->m_scrollText = "";
+                this->m_scrollStrip.reset();
                 this->m_ellipsisText = "";
                 this->m_maxWidth = 0;
+                this->markDirty();
             }
             
             /**
@@ -5933,6 +9407,7 @@ namespace tsl {
                 this->m_value = value;
                 this->m_faint = faint;
                 this->m_maxWidth = 0;
+                this->markDirty();
             }
             
             /**
@@ -5959,6 +9434,7 @@ namespace tsl {
             std::string m_value = "";
             std::string m_scrollText = "";
             std::string m_ellipsisText = "";
+            std::shared_ptr<const gfx::Glyph> m_scrollStrip;    // Rasterized m_scrollText while focused
             
             bool m_scroll = false;
             bool m_trunctuated = false;
@@ -5994,6 +9470,10 @@ namespace tsl {
             }
             
             virtual ~ToggleListItem() {}
+
+            virtual const char* getClassName() const override {
+                return "ToggleListItem";
+            }
             
             virtual bool onClick(u64 keys) override {
                 if (simulatedSelect && !simulatedSelectComplete) {
@@ -6065,6 +9545,10 @@ namespace tsl {
             }
             
             virtual ~DummyListItem() {}
+
+            virtual const char* getClassName() const override {
+                return "DummyListItem";
+            }
             
             // Override the draw method to do nothing
             virtual void draw(gfx::Renderer* renderer) override {
@@ -6102,6 +9586,10 @@ namespace tsl {
                 applyLangReplacements(m_text);
             }
             virtual ~CategoryHeader() {}
+
+            virtual const char* getClassName() const override {
+                return "CategoryHeader";
+            }
             
             virtual void draw(gfx::Renderer *renderer) override {
                 if (this->m_hasSeparator) {
@@ -6140,6 +9628,7 @@ namespace tsl {
             
             inline void setText(const std::string &text) {
                 this->m_text = text;
+                this->markDirty();
             }
             
             inline const std::string& getText() const {
@@ -6211,6 +9700,10 @@ namespace tsl {
             }
             
             virtual ~TrackBar() {}
+
+            virtual const char* getClassName() const override {
+                return "TrackBar";
+            }
             
             virtual Element* requestFocus(Element *oldFocus, FocusDirection direction) {
                 return this;
@@ -6383,6 +9876,7 @@ namespace tsl {
                     return false;
 
                 if (event == TouchEvent::Release) {
+                    this->markDirty();
                     //if (!m_executeOnEveryTick)
                     updateAndExecute();
                     this->m_interactionLocked = false;
@@ -6392,6 +9886,7 @@ namespace tsl {
                 
                 if (!this->m_interactionLocked && (touchInCircle || touchInSliderBounds)) {
                     touchInSliderBounds = true; // Always keep touchInSliderBounds true while dragging
+                    this->markDirty();
                     // Calculate the new index based on the touch position
                     s16 newIndex = static_cast<s16>((currX - (layerEdge + this->getX() + 59)) / static_cast<float>(this->getWidth() - 95) * (m_numSteps - 1));
                     
@@ -6566,6 +10061,7 @@ namespace tsl {
             
             virtual void setProgress(u8 value) {
                 this->m_value = value;
+                this->markDirty();
             }
             
             void setValueChangedListener(std::function<void(u8)> valueChangedListener) {
@@ -6639,6 +10135,10 @@ namespace tsl {
                 }
             
             virtual ~StepTrackBar() {}
+
+            virtual const char* getClassName() const override {
+                return "StepTrackBar";
+            }
             
             virtual inline bool handleInput(u64 keysDown, u64 keysHeld, const HidTouchState &touchPos, HidAnalogStickState leftJoyStick, HidAnalogStickState rightJoyStick) override {
                 static u32 tick = 0;
@@ -6759,6 +10259,7 @@ namespace tsl {
             virtual void setProgress(u8 value) override {
                 value = std::min(value, u8(this->m_numSteps - 1));
                 this->m_value = value * (100 / (this->m_numSteps - 1));
+                this->markDirty();
             }
             
         //protected:
@@ -6792,6 +10293,10 @@ namespace tsl {
                 }
             
             virtual ~NamedStepTrackBar() {}
+
+            virtual const char* getClassName() const override {
+                return "NamedStepTrackBar";
+            }
                         
             virtual void draw(gfx::Renderer *renderer) override {
                 // TrackBar width excluding the handle areas
@@ -6991,8 +10496,26 @@ namespace tsl {
          * @param renderer
          */
         void draw(gfx::Renderer *renderer) {
+            if (this->m_topElement == nullptr)
+                return;
+
+            // The top element isn't drawn through Element::frame, book it here
+            const u64 profileStartNs = useFrameProfiler ? gfx::FrameProfiler::beginElement() : 0;
+            this->m_topElement->draw(renderer);
+            if (useFrameProfiler)
+                gfx::FrameProfiler::endElement(this->m_topElement->getClassName(), profileStartNs);
+        }
+        
+        /**
+         * @brief Lets the top level and the focused element report damage from running animations
+         *
+         */
+        void pollDamage() {
             if (this->m_topElement != nullptr)
-                this->m_topElement->draw(renderer);
+                this->m_topElement->pollDamage();
+            
+            if (this->m_focusedElement != nullptr)
+                this->m_focusedElement->pollDamage();
         }
         
         inline bool initialFocusSet() {
@@ -7087,6 +10610,7 @@ namespace tsl {
 
             isHidden.store(false);
             this->onShow();
+            gfx::Renderer::invalidateAll();
             
             if (auto& currGui = this->getCurrentGui(); currGui != nullptr) // TESTING DISABLED (EFFECTS NEED TO BE VERIFIED)
                 currGui->restoreFocus();
@@ -7163,6 +10687,15 @@ namespace tsl {
 
         bool m_shouldHide = false;
         bool m_shouldClose = false;
+
+        // Frame profiler HUD, below the header on the left
+        static constexpr s32 ProfilerHudX = 8, ProfilerHudY = 100, ProfilerHudWidth = 210;
+        static constexpr s32 ProfilerHudFontSize = 13, ProfilerHudLineHeight = 16;
+        static constexpr size_t ProfilerHudElements = 4;
+        static constexpr s32 ProfilerHudHeight = (1 + static_cast<s32>(gfx::FrameProfiler::Stage::Count) + ProfilerHudElements) * ProfilerHudLineHeight + 8;
+        bool m_profilerActive = false;
+        u64 m_profilerHudUpdateNs = 0;
+        std::vector<std::string> m_profilerHudLines;
         
         bool m_disableNextAnimation = false;
         
@@ -7254,18 +10787,107 @@ namespace tsl {
         
         /**
          * @brief Main loop
+         * @note Frames where nothing on screen changed are skipped, the layer keeps showing the last one
          *
+         * @return Whether a frame was drawn
          */
-        void loop() {
+        bool loop() {
             auto& renderer = gfx::Renderer::get();
             
-            renderer.startFrame();
-            
+            this->updateProfilerHud();
+            const u64 updateStartNs = useFrameProfiler ? hlp::getTimeNs() : 0;
+
+            // Update the fade first so the damage check sees this frame's opacity
             this->animationLoop();
             this->getCurrentGui()->update();
-            this->getCurrentGui()->draw(&renderer);
+            this->getCurrentGui()->pollDamage();
             
-            renderer.endFrame();
+            if (!renderer.hasPendingDamage())
+                return false;
+
+            // Updates of skipped frames aren't booked, only frames that reach the screen get profiled
+            if (useFrameProfiler)
+                gfx::FrameProfiler::addStage(gfx::FrameProfiler::Stage::Update, hlp::getTimeNs() - updateStartNs);
+            
+            renderer.renderFrame([this](gfx::Renderer* renderer) {
+                const u64 drawStartNs = useFrameProfiler ? hlp::getTimeNs() : 0;
+                this->getCurrentGui()->draw(renderer);
+
+                if (useFrameProfiler) {
+                    gfx::FrameProfiler::addStage(gfx::FrameProfiler::Stage::Draw, hlp::getTimeNs() - drawStartNs);
+                    this->drawProfilerHud(renderer);
+                }
+            });
+
+            if (useFrameProfiler)
+                gfx::FrameProfiler::commitFrame();
+            
+            return true;
+        }
+
+        /**
+         * @brief Refreshes the frame profiler HUD text twice a second and damages the HUD when it changed
+         * @note Also starts a fresh profile when the profiler got switched on and clears the HUD when it got switched off
+         */
+        void updateProfilerHud() {
+            if (useFrameProfiler != this->m_profilerActive) {
+                this->m_profilerActive = useFrameProfiler;
+                if (useFrameProfiler)
+                    gfx::FrameProfiler::reset();
+                else
+                    gfx::FrameProfiler::flush();
+
+                this->m_profilerHudLines.clear();
+                this->m_profilerHudUpdateNs = 0;
+                gfx::Renderer::addDamage(ProfilerHudX, ProfilerHudY, ProfilerHudWidth, ProfilerHudHeight);
+            }
+
+            if (!useFrameProfiler)
+                return;
+
+            const u64 nowNs = hlp::getTimeNs();
+            if (nowNs - this->m_profilerHudUpdateNs < 500'000'000ULL)
+                return;
+            this->m_profilerHudUpdateNs = nowNs;
+
+            static const char* const stageNames[] = { "update", "draw", "raster", "present" };
+            std::vector<std::string> lines;
+            char line[64];
+
+            lines.emplace_back(runningInterpreter.load(std::memory_order_acquire) ? "p50/p95 us  (interpreter)" : "p50/p95 us");
+            for (size_t i = 0; i < static_cast<size_t>(gfx::FrameProfiler::Stage::Count); ++i) {
+                const auto stage = gfx::FrameProfiler::getStage(static_cast<gfx::FrameProfiler::Stage>(i));
+                snprintf(line, sizeof(line), "%-10s %5u/%5u", stageNames[i], stage.p50, stage.p95);
+                lines.emplace_back(line);
+            }
+            for (const auto& [name, element] : gfx::FrameProfiler::getTopElements(ProfilerHudElements)) {
+                snprintf(line, sizeof(line), "%-10.10s %5u/%5u", name, element.p50, element.p95);
+                lines.emplace_back(line);
+            }
+
+            if (lines != this->m_profilerHudLines) {
+                this->m_profilerHudLines = std::move(lines);
+                gfx::Renderer::addDamage(ProfilerHudX, ProfilerHudY, ProfilerHudWidth, ProfilerHudHeight);
+            }
+        }
+
+        /**
+         * @brief Draws the frame profiler HUD on top of the frame
+         *
+         * @param renderer Renderer
+         */
+        void drawProfilerHud(gfx::Renderer* renderer) {
+            if (this->m_profilerHudLines.empty())
+                return;
+
+            const s32 height = static_cast<s32>(this->m_profilerHudLines.size()) * ProfilerHudLineHeight + 8;
+            renderer->drawRect(ProfilerHudX, ProfilerHudY, ProfilerHudWidth, height, gfx::Renderer::a({ 0x0, 0x0, 0x0, 0xB }));
+
+            s32 y = ProfilerHudY + ProfilerHudLineHeight;
+            for (const std::string& line : this->m_profilerHudLines) {
+                renderer->drawString(line, true, ProfilerHudX + 6, y, ProfilerHudFontSize, gfx::Renderer::a({ 0xF, 0xF, 0xF, 0xF }));
+                y += ProfilerHudLineHeight;
+            }
         }
         
 
@@ -7305,6 +10927,14 @@ namespace tsl {
             auto topElement = currentGui->getTopElement();
             auto bottomElement = currentGui->getBottomElement();
             
+            // Whatever the focused element does with the input, it gets repainted
+            if (currentFocus != nullptr && ((keysDown | keysHeld) != 0 || touchDetected))
+                currentFocus->markDirty();
+
+            // Navigation has started, glyphs still missing get rasterized on demand from here on
+            if (keysDown != 0 || touchDetected)
+                gfx::Renderer::get().cancelGlyphPrewarm();
+            
             if (runningInterpreter.load()) {
                 if (keysDown & KEY_UP && !(keysDown & ~KEY_UP & ALL_KEYS_MASK))
                     currentFocus->shakeHighlight(FocusDirection::Up);
@@ -7541,9 +11171,10 @@ namespace tsl {
         void clearScreen() {
             auto& renderer = gfx::Renderer::get();
             
-            renderer.startFrame();
-            renderer.clearScreen();
-            renderer.endFrame();
+            renderer.renderFrame([](gfx::Renderer* renderer) {
+                renderer->clearScreen();
+            });
+            renderer.waitForRenderThread();
         }
         
         /**
@@ -7581,6 +11212,7 @@ namespace tsl {
             
             // Push the new Gui onto the stack
             this->m_guiStack.push(std::move(gui));
+            gfx::Renderer::invalidateAll();
             
             return this->m_guiStack.top();
         }
@@ -7609,16 +11241,21 @@ namespace tsl {
                 return;
             }
             
+            // Recorded frames may still point at memory owned by the Gui's elements, e.g. bitmaps
+            gfx::Renderer::get().waitForRenderThread();
             if (!this->m_guiStack.empty())
                 this->m_guiStack.pop();
+            gfx::Renderer::invalidateAll();
             
             if (this->m_guiStack.empty())
                 this->close();
         }
 
         void pop() {
+            gfx::Renderer::get().waitForRenderThread();
             if (!this->m_guiStack.empty())
                 this->m_guiStack.pop();
+            gfx::Renderer::invalidateAll();
         }
         
         template<typename G, typename ...Args>
@@ -7646,6 +11283,7 @@ namespace tsl {
             bool running = false;
             
             Event comboEvent = { 0 };
+            Event inputEvent = { 0 };  // Wakes up the render loop while it skips idle frames
             
             bool overlayOpen = false;
             
@@ -7780,6 +11418,7 @@ namespace tsl {
 
             s32 idx;
             Result rc;
+            bool inputWasActive = false;
 
             while (shData->running) {
                 // Scan for input changes
@@ -7877,6 +11516,12 @@ namespace tsl {
                     }
                     
                     shData->keysDownPending |= shData->keysDown;
+                    
+                    // Also wake up once after the last input so releases get handled right away
+                    const bool inputActive = (shData->keysDown | shData->keysHeld) != 0 || shData->touchState.count > 0;
+                    if (inputActive || inputWasActive)
+                        eventFire(&shData->inputEvent);
+                    inputWasActive = inputActive;
                 }
                 
                 //20 ms
@@ -7887,6 +11532,7 @@ namespace tsl {
                         if (shData->overlayOpen) {
                             tsl::Overlay::get()->hide();
                             shData->overlayOpen = false;
+                            eventFire(&shData->inputEvent);
                         }
                     }
                     
@@ -7909,9 +11555,11 @@ namespace tsl {
                             break;
                         case WaiterObject_CaptureButton:
                             disableTransparency = true;
+                            eventFire(&shData->inputEvent);
                             eventClear(&captureButtonPressEvent);
                             svcSleepThread(300'000'000);
                             disableTransparency = false;
+                            eventFire(&shData->inputEvent);
                             break;
                     }
                 } else if (rc != KERNELRESULT(TimedOut)) {
@@ -7996,6 +11644,7 @@ namespace tsl {
         impl::SharedThreadData shData;
         
         shData.running = true;
+        eventCreate(&shData.inputEvent, false);
         
         Thread backgroundThread;
         threadCreate(&backgroundThread, impl::backgroundEventPoller, &shData, nullptr, 0x1000, 0x2c, -2);
@@ -8011,6 +11660,9 @@ namespace tsl {
         overlay->initScreen();
         overlay->changeTo(overlay->loadInitialGui());
 
+        // The initial Gui loaded the language, rasterize its glyphs while the overlay is still hidden
+        gfx::Renderer::get().prewarmGlyphs();
+
         if (isLauncher && firstBoot) {
             setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, IN_OVERLAY_STR, FALSE_STR);
         }
@@ -8027,6 +11679,8 @@ namespace tsl {
 
         overlay->disableNextAnimation();
         
+        constexpr u64 IdleWakeupInterval = 16'666'666; // One display frame
+        
         while (shData.running) {
             
             eventWait(&shData.comboEvent, UINT64_MAX);
@@ -8040,7 +11694,12 @@ namespace tsl {
             overlay->clearScreen();
             
             while (shData.running) {
-                overlay->loop();
+                if (!overlay->loop()) {
+                    // Nothing changed on screen, sleep until new input arrives or the next animation step is due
+                    eventWait(&shData.inputEvent, IdleWakeupInterval);
+                    eventClear(&shData.inputEvent);
+                }
+                
                 {
                     std::scoped_lock lock(shData.dataMutex);
                     if (!overlay->fadeAnimationPlaying()) {
@@ -8070,6 +11729,7 @@ namespace tsl {
         eventClose(&shData.comboEvent);
         
         threadWaitForExit(&backgroundThread);
+        eventClose(&shData.inputEvent);
         threadClose(&backgroundThread);
         
         overlay->exitScreen();
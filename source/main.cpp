@@ -461,6 +461,8 @@ private:
                 redrawWidget = true;
             } else if (iniKey == "right_alignment") {
                 triggerMenuReload = (rightAlignmentState != state);
+            } else if (iniKey == "frame_profiler") {
+                useFrameProfiler = newState;
             }
     
             reloadMenu = true;
@@ -704,6 +706,7 @@ public:
                     }
                     else initializeTheme();
                     tsl::initializeThemeVars();
+                    tsl::gfx::Renderer::invalidateAll();
                     reloadMenu = reloadMenu2 = true;
                     lastSelectedListItem->setValue("");
                     selectedListItem->setValue(DEFAULT);
@@ -744,6 +747,7 @@ public:
                         copyPercentage.store(-1, std::memory_order_release);
                         initializeTheme();
                         tsl::initializeThemeVars();
+                        tsl::gfx::Renderer::invalidateAll();
                         reloadMenu = reloadMenu2 = true;
                         lastSelectedListItem->setValue("");
                         selectedListItem->setValue(themeName);
@@ -778,7 +782,9 @@ public:
                 if (keys & KEY_A) {
                     setIniFileValue(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "current_wallpaper", "");
                     deleteFileOrDirectory(WALLPAPER_PATH);
+                    deleteFileOrDirectory(WALLPAPER_PATH + "4"); // packed wallpaper cache
                     reloadWallpaper();
+                    tsl::gfx::Renderer::invalidateAll();
                     //refreshWallpaper.store(true, std::memory_order_release);
 
                     //deleteFileOrDirectory(THEME_CONFIG_INI_PATH);
@@ -825,6 +831,7 @@ public:
                         copyFileOrDirectory(wallpaperFile, WALLPAPER_PATH);
                         copyPercentage.store(-1, std::memory_order_release);
                         reloadWallpaper();
+                        tsl::gfx::Renderer::invalidateAll();
                         
                         //clearWallpaperData();
                         //initializeTheme();
@@ -880,6 +887,9 @@ public:
 
             useOpaqueScreenshots = (parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "opaque_screenshots") == TRUE_STR);
             createToggleListItem(list, OPAQUE_SCREENSHOTS, useOpaqueScreenshots, "opaque_screenshots");
+
+            useFrameProfiler = (parseValueFromIniSection(ULTRAHAND_CONFIG_INI_PATH, ULTRAHAND_PROJECT_NAME, "frame_profiler") == TRUE_STR);
+            createToggleListItem(list, FRAME_PROFILER, useFrameProfiler, "frame_profiler");
             
         
         } else {
@@ -4191,6 +4201,7 @@ public:
                 setDefaultValue(ultrahandSection, "swipe_to_open", TRUE_STR, useSwipeToOpen);
                 setDefaultValue(ultrahandSection, "right_alignment", FALSE_STR, useRightAlignment);
                 setDefaultValue(ultrahandSection, "opaque_screenshots", TRUE_STR, useOpaqueScreenshots);
+                setDefaultValue(ultrahandSection, "frame_profiler", FALSE_STR, useFrameProfiler);
                 //setDefaultValue(ultrahandSection, "progress_animation", FALSE_STR, progressAnimation);
                 
                 setDefaultStrValue(ultrahandSection, DEFAULT_LANG_STR, defaultLang, defaultLang);
@@ -3314,12 +3314,14 @@ void processCommand(const std::vector<std::string>& cmd, const std::string& pack
         else if (cmd.size() > 1) {
             std::string refreshPattern = cmd[1];
             removeQuotes(refreshPattern);
-            if (refreshPattern == "theme")
+            if (refreshPattern == "theme") {
                 tsl::initializeThemeVars();
-            else if (refreshPattern == "package")
+                tsl::gfx::Renderer::invalidateAll();
+            } else if (refreshPattern == "package")
                 refreshPackage = true;
             else if (refreshPattern == "wallpaper") {
                 reloadWallpaper();
+                tsl::gfx::Renderer::invalidateAll();
             }
         }
     } else if (commandName == "logging") {